@@ -1,7 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <list>
+#include <memory_resource>
 #include <vector>
 #include <memory>
 #include <iostream>
@@ -10,6 +12,8 @@
 #include <unordered_map>
 #include <mutex>
 #include "Cachepolicy.h"
+#include "CacheExecutor.h"
+#include "RemovalListener.h"
 using namespace std;
 namespace CacheDemo {
 
@@ -19,7 +23,7 @@ struct Node {
   Key key;
   Value value;
   size_t freq;
-  typename std::list<Node>::iterator listIt;  // 记录该节点在链表中的位置
+  typename std::pmr::list<Node>::iterator listIt;  // 记录该节点在链表中的位置
 
   Node(Key k, Value v, size_t f = 1)
       : key(k), value(v), freq(f) {}
@@ -29,33 +33,58 @@ struct Node {
 template<typename Key, typename Value>
 class ArcLruPart {
 public:
-    using ListType = std::list<Node<Key, Value>>;  // 使用 Node<Key, Value>
+    using ListType = std::pmr::list<Node<Key, Value>>;  // 使用 Node<Key, Value>
     using ListIterator = typename ListType::iterator;
-    using Hashmap = std::unordered_map<Key, ListIterator>;  // {key, ListIterator}
+    using Hashmap = std::pmr::unordered_map<Key, ListIterator>;  // {key, ListIterator}
+    using GhostSet = std::pmr::unordered_set<Key>;
+    using GhostKeys = std::pmr::vector<Key>;
 
-    explicit ArcLruPart(size_t capacity, size_t transformThreshold)
-        : capacity_(capacity), transformThreshold_(transformThreshold) {
+    // resource 用于节点、索引和 ghost 表；设置了执行器时节点在后台线程释放，resource 需线程安全
+    explicit ArcLruPart(size_t capacity, size_t transformThreshold,
+                        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : capacity_(capacity), transformThreshold_(transformThreshold),
+          cacheList_(resource), cacheMap_(resource), ghostCache_(resource),
+          retired_(resource), pendingGhost_(resource) {
         cacheMap_.reserve(capacity);
     }
 
-    bool put(Key key, Value value) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = cacheMap_.find(key);
-        if (it != cacheMap_.end()) {
-            // 更新值并增加访问次数
-            it->second->value = value;
-            it->second->freq++;
-            moveToFront(it->second);
-            return false;
-        }
+    ~ArcLruPart() {
+        // 等待仍引用本对象的后台 ghost 维护任务结束
+        if (executor_) executor_->flush();
+    }
 
-        if (cacheList_.size() >= capacity_) {
-            evict();
-        }
+    // removed 非空时收集本次操作移除的数据，用于上层发布移除事件
+    bool put(Key key, Value value, std::vector<RemovalNotification<Key, Value>>* removed = nullptr) {
+        ListType garbage(retired_.get_allocator());
+        GhostKeys ghostKeys(pendingGhost_.get_allocator());
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = cacheMap_.find(key);
+            if (it != cacheMap_.end()) {
+                // 更新值并增加访问次数
+                if (removed) {
+                    removed->push_back({key, std::move(it->second->value), RemovalCause::Replaced});
+                }
+                it->second->value = value;
+                it->second->freq++;
+                moveToFront(it->second);
+                return false;
+            }
 
-        // 创建新节点并将其插入到链表头
-        cacheList_.push_front(Node<Key, Value>(key, value));
-        cacheMap_[key] = cacheList_.begin();  // 保存节点的迭代器
+            if (cacheList_.size() >= capacity_) {
+                evict(removed);
+            }
+
+            // 创建新节点并将其插入到链表头
+            cacheList_.push_front(Node<Key, Value>(key, value));
+            cacheMap_[key] = cacheList_.begin();  // 保存节点的迭代器
+
+            if (retired_.size() >= RETIRE_BATCH) {
+                garbage.swap(retired_);
+                ghostKeys.swap(pendingGhost_);
+            }
+        }
+        postRetired(garbage, ghostKeys);
         return true;
     }
 
@@ -77,6 +106,22 @@ public:
         return true;
     }
 
+    bool contains(const Key& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return cacheMap_.find(key) != cacheMap_.end();
+    }
+
+    // 只读取值，不增加访问次数也不调整位置
+    bool peek(const Key& key, Value& value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = cacheMap_.find(key);
+        if (it == cacheMap_.end()) {
+            return false;
+        }
+        value = it->second->value;
+        return true;
+    }
+
     bool checkGhost(Key key) {
         std::lock_guard<std::mutex> lock(mutex_);
         return ghostCache_.find(key) != ghostCache_.end();
@@ -96,18 +141,62 @@ public:
         return false;
     }
 
+    // 清空并把容量恢复为 capacity；已投递的 ghost 任务仍可能写入少量旧 key，只影响容量自适应
+    void clear(size_t capacity) {
+        ListType list(cacheList_.get_allocator());
+        Hashmap map(cacheMap_.get_allocator());
+        map.reserve(capacity);
+        GhostSet ghost(ghostCache_.get_allocator());
+        ListType retired(retired_.get_allocator());
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            capacity_ = capacity;
+            list.swap(cacheList_);
+            map.swap(cacheMap_);
+            ghost.swap(ghostCache_);
+            retired.swap(retired_);
+            pendingGhost_.clear();
+        }
+        releaseLater(executor_.get(), std::move(list), std::move(map), std::move(ghost), std::move(retired));
+    }
+
+    void setExecutor(std::shared_ptr<CacheExecutor> executor) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        executor_ = std::move(executor);
+    }
+
 private:
     void moveToFront(ListIterator nodeIt) {
         cacheList_.splice(cacheList_.begin(), cacheList_, nodeIt);
     }
 
-    void evict() {
+    void evict(std::vector<RemovalNotification<Key, Value>>* removed) {
         if (cacheList_.empty()) return;
 
         auto last = --cacheList_.end();
-        ghostCache_.insert(last->key);
         cacheMap_.erase(last->key);
-        cacheList_.erase(last);
+        if (removed) {
+            removed->push_back({last->key, std::move(last->value), RemovalCause::Capacity});
+        }
+        if (executor_) {
+            // ghost 表的插入与节点析构攒批后交给后台线程
+            pendingGhost_.push_back(last->key);
+            retired_.splice(retired_.end(), cacheList_, last);
+        } else {
+            ghostCache_.insert(last->key);
+            cacheList_.erase(last);
+        }
+    }
+
+    void postRetired(ListType& garbage, GhostKeys& ghostKeys) {
+        if (garbage.empty()) return;
+        executor_->post([this, nodes = std::move(garbage), keys = std::move(ghostKeys)]() mutable {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ghostCache_.insert(keys.begin(), keys.end());
+            }
+            nodes.clear();
+        });
     }
 
 private:
@@ -115,7 +204,10 @@ private:
     size_t transformThreshold_;
     ListType cacheList_;   // 维护 LRU 访问顺序{list<node>}
     Hashmap cacheMap_;  // {key, list<node>->iterator}
-    std::unordered_set<Key> ghostCache_;  // 存储淘汰的 key
+    GhostSet ghostCache_;  // 存储淘汰的 key
+    ListType retired_;  // 等待后台析构的节点
+    GhostKeys pendingGhost_;  // 等待后台写入 ghost 表的 key
+    std::shared_ptr<CacheExecutor> executor_;
     std::mutex mutex_;  // 用于加锁
 };
 
@@ -123,33 +215,55 @@ private:
 template<typename Key, typename Value>
 class ArcLfuPart {
 public:
-    using ListType = std::list<Node<Key, Value>>;  // 使用 Node<Key, Value>
+    using ListType = std::pmr::list<Node<Key, Value>>;  // 使用 Node<Key, Value>
     using ListIterator = typename ListType::iterator;
-    using Hashmap = std::unordered_map<Key, ListIterator>;  // {key, Node iterator}
-    using FreqMap = std::unordered_map<size_t, ListType>;  // freq -> ListType
+    using Hashmap = std::pmr::unordered_map<Key, ListIterator>;  // {key, Node iterator}
+    using FreqMap = std::pmr::unordered_map<size_t, ListType>;  // freq -> ListType
+    using GhostSet = std::pmr::unordered_set<Key>;
+    using GhostKeys = std::pmr::vector<Key>;
     
-    explicit ArcLfuPart(size_t capacity, size_t transformThreshold)
-        : capacity_(capacity), transformThreshold_(transformThreshold), minFreq_(1) {}
+    // resource 用于节点、索引、频次表和 ghost 表，要求同 ArcLruPart
+    explicit ArcLfuPart(size_t capacity, size_t transformThreshold,
+                        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : capacity_(capacity), transformThreshold_(transformThreshold), minFreq_(1),
+          freqMap_(resource), cacheMap_(resource), ghostCache_(resource),
+          retired_(resource), pendingGhost_(resource) {}
+
+    ~ArcLfuPart() {
+        // 等待仍引用本对象的后台 ghost 维护任务结束
+        if (executor_) executor_->flush();
+    }
 
-    bool put(Key key, Value value) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = cacheMap_.find(key);
-        if (it != cacheMap_.end()) {
-            // 更新值并增加访问次数
-            ListIterator nodeIt = it->second;
-            nodeIt->value = value;
-            increaseFreq(nodeIt);  // 更新频率并将节点移到正确的频率链表
-            return true;
-        }
+    // removed 非空时收集本次操作移除的数据，用于上层发布移除事件
+    bool put(Key key, Value value, std::vector<RemovalNotification<Key, Value>>* removed = nullptr) {
+        ListType garbage(retired_.get_allocator());
+        GhostKeys ghostKeys(pendingGhost_.get_allocator());
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = cacheMap_.find(key);
+            if (it != cacheMap_.end()) {
+                // 更新值并增加访问次数
+                ListIterator nodeIt = it->second;
+                nodeIt->value = value;
+                increaseFreq(nodeIt);  // 更新频率并将节点移到正确的频率链表
+                return true;
+            }
 
-        if (cacheMap_.size() >= capacity_) {
-            evict();
-        }
+            if (cacheMap_.size() >= capacity_) {
+                evict(removed);
+            }
 
-        // 插入新节点，频率为 1
-        freqMap_[1].emplace_front(key, value, 1);
-        cacheMap_[key] = freqMap_[1].begin();  // 存储指向新插入节点的迭代器
-        minFreq_ = 1;  // 初始时最低频率为 1
+            // 插入新节点，频率为 1
+            freqMap_[1].emplace_front(key, value, 1);
+            cacheMap_[key] = freqMap_[1].begin();  // 存储指向新插入节点的迭代器
+            minFreq_ = 1;  // 初始时最低频率为 1
+
+            if (retired_.size() >= RETIRE_BATCH) {
+                garbage.swap(retired_);
+                ghostKeys.swap(pendingGhost_);
+            }
+        }
+        postRetired(garbage, ghostKeys);
         return true;
     }
 
@@ -166,6 +280,22 @@ public:
         return true;
     }
 
+    bool contains(const Key& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return cacheMap_.find(key) != cacheMap_.end();
+    }
+
+    // 只读取值，不增加访问次数也不调整位置
+    bool peek(const Key& key, Value& value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = cacheMap_.find(key);
+        if (it == cacheMap_.end()) {
+            return false;
+        }
+        value = it->second->value;
+        return true;
+    }
+
     bool checkGhost(Key key) {
         std::lock_guard<std::mutex> lock(mutex_);
         return ghostCache_.find(key) != ghostCache_.end();
@@ -185,39 +315,68 @@ public:
         return false;
     }
 
+    // 清空并把容量恢复为 capacity；已投递的 ghost 任务仍可能写入少量旧 key，只影响容量自适应
+    void clear(size_t capacity) {
+        FreqMap freqMap(freqMap_.get_allocator());
+        Hashmap map(cacheMap_.get_allocator());
+        GhostSet ghost(ghostCache_.get_allocator());
+        ListType retired(retired_.get_allocator());
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            capacity_ = capacity;
+            minFreq_ = 1;
+            freqMap.swap(freqMap_);
+            map.swap(cacheMap_);
+            ghost.swap(ghostCache_);
+            retired.swap(retired_);
+            pendingGhost_.clear();
+        }
+        releaseLater(executor_.get(), std::move(freqMap), std::move(map), std::move(ghost), std::move(retired));
+    }
+
+    void setExecutor(std::shared_ptr<CacheExecutor> executor) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        executor_ = std::move(executor);
+    }
+
 private:
     void increaseFreq(ListIterator nodeIt) {
         size_t oldFreq = nodeIt->freq;
         size_t newFreq = oldFreq + 1;
 
-        // 先在 cacheMap_ 里删除旧的迭代器
-        cacheMap_.erase(nodeIt->key);
-
-        // 先移除旧频次链表中的节点
-        freqMap_[oldFreq].erase(nodeIt);
-        if (freqMap_[oldFreq].empty()) {
+        // 把节点整体移到新频次链表头部，迭代器不变，cacheMap_ 无需更新
+        ListType& oldList = freqMap_[oldFreq];
+        ListType& newList = freqMap_[newFreq];
+        newList.splice(newList.begin(), oldList, nodeIt);
+        nodeIt->freq = newFreq;
+        if (oldList.empty()) {
             freqMap_.erase(oldFreq);
         }
 
-        // 插入到新频次的链表头部
-        freqMap_[newFreq].emplace_front(nodeIt->key, nodeIt->value, newFreq);
-        cacheMap_[nodeIt->key] = freqMap_[newFreq].begin();
-
         // 更新 minFreq_
         if (freqMap_.find(minFreq_) == freqMap_.end()) {
             minFreq_ = newFreq;
         }
     }
 
-    void evict() {
+    void evict(std::vector<RemovalNotification<Key, Value>>* removed) {
         if (freqMap_.empty()) return;
 
         // 淘汰最低频率的节点
         auto& minFreqList = freqMap_[minFreq_];
         auto last = --minFreqList.end();
-        ghostCache_.insert(last->key);  // 将淘汰的节点放入 ghostCache
         cacheMap_.erase(last->key);
-        minFreqList.erase(last);
+        if (removed) {
+            removed->push_back({last->key, std::move(last->value), RemovalCause::Capacity});
+        }
+        if (executor_) {
+            // ghost 表的插入与节点析构攒批后交给后台线程
+            pendingGhost_.push_back(last->key);
+            retired_.splice(retired_.end(), minFreqList, last);
+        } else {
+            ghostCache_.insert(last->key);  // 将淘汰的节点放入 ghostCache
+            minFreqList.erase(last);
+        }
 
         // 如果当前最低频率的链表为空，更新最低频率
         if (minFreqList.empty()) {
@@ -231,13 +390,27 @@ private:
         }
     }
 
+    void postRetired(ListType& garbage, GhostKeys& ghostKeys) {
+        if (garbage.empty()) return;
+        executor_->post([this, nodes = std::move(garbage), keys = std::move(ghostKeys)]() mutable {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ghostCache_.insert(keys.begin(), keys.end());
+            }
+            nodes.clear();
+        });
+    }
+
 private:
     size_t capacity_;
     size_t transformThreshold_;
     size_t minFreq_;  // 记录当前最低频率
     FreqMap freqMap_;  // 存储频率到节点链表的映射
     Hashmap cacheMap_; // 存储 key 到节点迭代器的映射
-    std::unordered_set<Key> ghostCache_;  // 存储被淘汰的 key
+    GhostSet ghostCache_;  // 存储被淘汰的 key
+    ListType retired_;  // 等待后台析构的节点
+    GhostKeys pendingGhost_;  // 等待后台写入 ghost 表的 key
+    std::shared_ptr<CacheExecutor> executor_;
     std::mutex mutex_;  // 用于加锁
 };
 
@@ -246,25 +419,19 @@ private:
 template<typename Key, typename Value>
 class ArcCache : public Cachepolicy<Key, Value> {
 public:
-    explicit ArcCache(size_t capacity, size_t transformThreshold = 2)
+    // resource 由 LRU、LFU 两部分共用
+    explicit ArcCache(size_t capacity, size_t transformThreshold = 2,
+                      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
         : capacity_(capacity), transformThreshold_(transformThreshold),
-        lruPart_(std::make_unique<ArcLruPart<Key, Value>>(capacity, transformThreshold)),
-        lfuPart_(std::make_unique<ArcLfuPart<Key, Value>>(capacity, transformThreshold))
+        lruPart_(std::make_unique<ArcLruPart<Key, Value>>(capacity, transformThreshold, resource)),
+        lfuPart_(std::make_unique<ArcLfuPart<Key, Value>>(capacity, transformThreshold, resource))
     {}
 
     ~ArcCache() override = default;
 
     void put(const Key& key, const Value& value) override {
-        bool inGhost = checkGhostCaches(key);
- 
-        if (!inGhost) {
-            if (lruPart_->put(key, value)) {
-                lfuPart_->put(key, value);
-            }
-        } else {
-            lruPart_->put(key, value);
-        }
-       
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        putLocked(key, value);
     }
 
     bool get(const Key& key, Value& value) override {
@@ -273,7 +440,18 @@ public:
         bool shouldTransform = false;
         if (lruPart_->get(key, value, shouldTransform)) {
             if (shouldTransform) {
-                lfuPart_->put(key, value);
+                // 迁移与写入互斥，并在锁内重新读取，避免把并发写入之前的旧值写进 LFU 部分
+                std::lock_guard<std::mutex> lock(writeMutex_);
+                Value current;
+                if (lruPart_->peek(key, current)) {
+                    std::vector<RemovalNotification<Key, Value>> removed;
+                    lfuPart_->put(key, current, removalDispatcher_ ? &removed : nullptr);
+                    // 迁移到 LFU 部分写入的是同一个值，不算覆盖
+                    removed.erase(std::remove_if(removed.begin(), removed.end(),
+                        [](const RemovalNotification<Key, Value>& n) { return n.cause == RemovalCause::Replaced; }),
+                        removed.end());
+                    publishRemovals(removed);
+                }
             }
             return true;
         }
@@ -281,13 +459,116 @@ public:
         return lfuPart_->get(key, value);
     }
 
+    // 以下读-改-写操作与 put 在同一把写锁内完成，fn 在锁内执行，不能再访问本缓存；
+    // 查找不计入访问次数，写入与 put 相同
+    Value compute(const Key& key, const typename Cachepolicy<Key, Value>::ComputeFn& fn) override {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        Value old;
+        Value value = fn(peekLocked(key, old) ? &old : nullptr);
+        putLocked(key, value);
+        return value;
+    }
+
+    bool computeIfPresent(const Key& key, const typename Cachepolicy<Key, Value>::UpdateFn& fn) override {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        Value old;
+        if (!peekLocked(key, old)) return false;
+        putLocked(key, fn(old));
+        return true;
+    }
+
+    bool putIfAbsent(const Key& key, const Value& value) override {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        Value old;
+        if (peekLocked(key, old)) return false;
+        putLocked(key, value);
+        return true;
+    }
+
+    bool compareAndSet(const Key& key, const Value& expected, const Value& desired) override {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        Value old;
+        if (!peekLocked(key, old) || !(old == expected)) return false;
+        putLocked(key, desired);
+        return true;
+    }
+
     Value get(Key key)  {
         Value value{};
         get(key, value);
         return value;
     }
 
+    // 两部分各自清空，容量恢复为初始值
+    void clear() override {
+        lruPart_->clear(capacity_);
+        lfuPart_->clear(capacity_);
+    }
+
+    // 设置后台维护执行器，两部分的淘汰节点析构与 ghost 维护都转到后台
+    void setExecutor(std::shared_ptr<CacheExecutor> executor) {
+        lruPart_->setExecutor(executor);
+        lfuPart_->setExecutor(executor);
+    }
+
+    // 设置移除监听，需在缓存投入使用前设置
+    // 只有 key 同时离开 LRU 和 LFU 两部分时才算容量淘汰
+    void setRemovalListener(std::shared_ptr<RemovalDispatcher<Key, Value>> dispatcher) {
+        removalDispatcher_ = std::move(dispatcher);
+    }
+
 private:
+    // 覆盖事件在这里统一发布：key 可能只在 LFU 部分（LRU 部分按新 key 插入，不会上报），
+    // 也可能两部分都有，交给各部分上报会漏报或重复（需持 writeMutex_ 调用）
+    void putLocked(const Key& key, const Value& value) {
+        bool inGhost = checkGhostCaches(key);
+        std::vector<RemovalNotification<Key, Value>> removed;
+        auto* sink = removalDispatcher_ ? &removed : nullptr;
+        Value old;
+        bool replaced = sink && peekLocked(key, old);
+
+        if (!inGhost) {
+            if (lruPart_->put(key, value, sink)) {
+                lfuPart_->put(key, value, sink);
+            }
+        } else {
+            lruPart_->put(key, value, sink);
+        }
+
+        if (sink) {
+            removed.erase(std::remove_if(removed.begin(), removed.end(),
+                [](const RemovalNotification<Key, Value>& n) { return n.cause == RemovalCause::Replaced; }),
+                removed.end());
+            if (replaced) removed.push_back({key, std::move(old), RemovalCause::Replaced});
+        }
+        publishRemovals(removed);
+    }
+
+    // 与 get 的查找顺序相同，先 LRU 部分再 LFU 部分（需持 writeMutex_ 调用）
+    bool peekLocked(const Key& key, Value& value) {
+        return lruPart_->peek(key, value) || lfuPart_->peek(key, value);
+    }
+
+    // 在两部分的锁外发布事件，同一次操作中两部分都淘汰了同一个 key 时只上报一次
+    void publishRemovals(std::vector<RemovalNotification<Key, Value>>& removed) {
+        for (size_t i = 0; i < removed.size(); ++i) {
+            auto& n = removed[i];
+            if (n.cause == RemovalCause::Capacity) {
+                bool duplicate = false;
+                for (size_t j = 0; j < i; ++j) {
+                    if (removed[j].cause == RemovalCause::Capacity && removed[j].key == n.key) {
+                        duplicate = true;
+                        break;
+                    }
+                }
+                if (duplicate || lruPart_->contains(n.key) || lfuPart_->contains(n.key)) {
+                    continue;
+                }
+            }
+            removalDispatcher_->publish(n.key, std::move(n.value), n.cause);
+        }
+    }
+
     bool checkGhostCaches(Key key) {
         bool inGhost = false;
         if (lruPart_->checkGhost(key)) {
@@ -310,6 +591,8 @@ private:
     size_t transformThreshold_;
     std::unique_ptr<ArcLruPart<Key, Value>> lruPart_;
     std::unique_ptr<ArcLfuPart<Key, Value>> lfuPart_;
+    std::shared_ptr<RemovalDispatcher<Key, Value>> removalDispatcher_;
+    std::mutex writeMutex_;  // 串行化跨两部分的写入，读不经过
 };
 
 } // namespace CacheDemo
@@ -0,0 +1,406 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <mutex>
+#include <unordered_map>
+#include "ARCCache.h"
+#include "Cachepolicy.h"
+#include "FIFOCache.h"
+#include "HashUtil.h"
+#include "IndexList.h"
+#include "LFUCache.h"
+#include "LRUCache.h"
+
+namespace CacheDemo
+{
+
+enum class AdaptivePolicy : uint8_t { LRU, LFU, ARC, FIFO };
+
+// 自适应缓存：条目同时挂在 LRU 链表和 LFU 频次桶上，淘汰时按权重 lfuWeight 随机选择
+// 用 LFU 的牺牲者（最低频次中最久未访问的）还是 LRU 的牺牲者（最久未访问的），
+// 权重 0 即 LRU，1 即 LFU，调整权重不需要重建缓存。
+// 按 key 哈希抽取 1/2^sampleShift 的 key，喂给按比例缩小的 LRU、LFU、ARC、FIFO 影子缓存（只存 key），
+// 每 window 次抽样访问比较一次各影子的命中率，把权重向领先者对应的值靠拢：
+// LRU、FIFO 对应 0，LFU 对应 1，ARC 领先说明近期性和频率都重要，对应 0.5
+template<typename Key, typename Value>
+class AdaptiveCache : public Cachepolicy<Key, Value>
+{
+private:
+    struct Node
+    {
+        Key key{};
+        Value value{};
+        uint32_t bucket = NIL_INDEX;
+        IndexLink recency;
+        IndexLink freqLink;
+    };
+
+    using RecencyList = IndexList<Node, &Node::recency>;
+    using FreqList = IndexList<Node, &Node::freqLink>;
+
+    // 同一频次的条目，head 为最近访问
+    struct Bucket
+    {
+        size_t freq = 0;
+        FreqList entries;
+        IndexLink link;
+    };
+
+    using BucketList = IndexList<Bucket, &Bucket::link>;
+
+    static constexpr size_t POLICY_COUNT = 4;
+    static constexpr size_t MIN_SHADOW_CAPACITY = 64;
+
+public:
+    using ComputeFn = typename Cachepolicy<Key, Value>::ComputeFn;
+    using UpdateFn = typename Cachepolicy<Key, Value>::UpdateFn;
+    using Index = std::pmr::unordered_map<Key, uint32_t>;
+
+    // sampleShift: 抽样 1/2^sampleShift 的 key，容量太小时自动减小，保证影子缓存至少有 MIN_SHADOW_CAPACITY 个位置；
+    // window: 每多少次抽样访问重新评估一次；resource 用于 key 索引
+    explicit AdaptiveCache(size_t capacity, int sampleShift = 6, size_t window = 256,
+                           std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : capacity_(capacity),
+          sampleShift_(shiftFor(capacity, sampleShift)),
+          window_(std::max<size_t>(1, window)),
+          pool_(capacity),
+          buckets_(capacity + 1),
+          index_(resource),
+          shadowLru_(shadowCapacity()),
+          shadowLfu_(shadowCapacity()),
+          // ARC 的两部分各自最多容纳 capacity 个 key，减半后与其他影子占用相当
+          shadowArc_(std::max<size_t>(1, shadowCapacity() / 2)),
+          shadowFifo_(shadowCapacity()),
+          shadowHits_{},
+          sampledAccesses_(0),
+          lfuWeight_(0.5),
+          leader_(AdaptivePolicy::ARC),
+          random_(0x9E3779B97F4A7C15ULL)
+    {
+        index_.reserve(capacity);
+    }
+
+    ~AdaptiveCache() override = default;
+
+    void put(const Key& key, const Value& value) override
+    {
+        if (capacity_ == 0) return;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it != index_.end())
+        {
+            pool_[it->second].value = value;
+            touch(it->second);
+            return;
+        }
+        insert(key, value);
+    }
+
+    // 抽样到的 key 同时更新影子缓存，未命中视为随后会写入
+    bool get(const Key& key, Value& value) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (sampled(key)) recordShadow(key);
+
+        auto it = index_.find(key);
+        if (it == index_.end()) return false;
+
+        value = pool_[it->second].value;
+        touch(it->second);
+        return true;
+    }
+
+    Value get(const Key& key)
+    {
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    // 以下读-改-写操作一次加锁完成，fn 在锁内执行，不能再访问本缓存；
+    // compute 相当于一次查找加回填，与 get 一样计入影子缓存
+    Value compute(const Key& key, const ComputeFn& fn) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (sampled(key)) recordShadow(key);
+
+        auto it = index_.find(key);
+        if (it != index_.end())
+        {
+            Node& node = pool_[it->second];
+            node.value = fn(&node.value);
+            touch(it->second);
+            return node.value;
+        }
+        Value value = fn(nullptr);
+        if (capacity_ > 0) insert(key, value);
+        return value;
+    }
+
+    bool computeIfPresent(const Key& key, const UpdateFn& fn) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end()) return false;
+
+        Node& node = pool_[it->second];
+        node.value = fn(node.value);
+        touch(it->second);
+        return true;
+    }
+
+    bool putIfAbsent(const Key& key, const Value& value) override
+    {
+        if (capacity_ == 0) return false;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (index_.find(key) != index_.end()) return false;
+        insert(key, value);
+        return true;
+    }
+
+    bool compareAndSet(const Key& key, const Value& expected, const Value& desired) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end() || !(pool_[it->second].value == expected)) return false;
+
+        pool_[it->second].value = desired;
+        touch(it->second);
+        return true;
+    }
+
+    // 新的节点池和索引在锁外准备好，持锁只做交换，旧数据在锁外释放；
+    // 影子缓存一并清空，已学到的权重保留
+    void clear() override
+    {
+        NodePool<Node> pool(pool_.size());
+        NodePool<Bucket> buckets(buckets_.size());
+        Index index(index_.get_allocator());
+        index.reserve(capacity_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pool.swap(pool_);
+            buckets.swap(buckets_);
+            index.swap(index_);
+            recency_ = RecencyList();
+            freqBuckets_ = BucketList();
+            shadowLru_.clear();
+            shadowLfu_.clear();
+            shadowArc_.clear();
+            shadowFifo_.clear();
+            shadowHits_.fill(0);
+            sampledAccesses_ = 0;
+        }
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    size_t size()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return index_.size();
+    }
+
+    // 当前淘汰时选择 LFU 牺牲者的概率
+    double lfuWeight()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return lfuWeight_;
+    }
+
+    // 最近一个评估窗口中命中率最高的影子策略
+    AdaptivePolicy leader()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return leader_;
+    }
+
+    // 手动设置权重，下一次评估时仍会被影子缓存的结果调整
+    void setLfuWeight(double weight)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lfuWeight_ = std::min(1.0, std::max(0.0, weight));
+    }
+
+private:
+    // 影子缓存至少 MIN_SHADOW_CAPACITY 个位置，否则命中率估计没有意义
+    static int shiftFor(size_t capacity, int sampleShift)
+    {
+        int shift = std::max(0, sampleShift);
+        while (shift > 0 && (capacity >> shift) < MIN_SHADOW_CAPACITY) --shift;
+        return shift;
+    }
+
+    size_t shadowCapacity() const { return std::max<size_t>(1, capacity_ >> sampleShift_); }
+
+    // 打散后取低位抽样
+    bool sampled(const Key& key) const
+    {
+        return (mixHash(std::hash<Key>()(key)) & ((uint64_t(1) << sampleShift_) - 1)) == 0;
+    }
+
+    // 在每个影子缓存上模拟一次“查找，未命中则写入”，满一个窗口就重新评估（需持锁调用）
+    void recordShadow(const Key& key)
+    {
+        std::array<Cachepolicy<Key, bool>*, POLICY_COUNT> shadows = {&shadowLru_, &shadowLfu_, &shadowArc_, &shadowFifo_};
+        for (size_t p = 0; p < POLICY_COUNT; ++p)
+        {
+            bool present = false;
+            if (shadows[p]->get(key, present))
+            {
+                ++shadowHits_[p];
+            }
+            else
+            {
+                shadows[p]->put(key, true);
+            }
+        }
+        if (++sampledAccesses_ >= window_) adapt();
+    }
+
+    // 权重向领先者对应的值移动一半，避免在相近的策略间来回跳，足够接近时直接取目标值。
+    // 命中数相同时按 LRU、LFU、FIFO 的顺序取前者；活跃缓存只能近似 ARC，
+    // 所以 ARC 要比 LRU、LFU 都多出 window 的 1/32 才算领先
+    void adapt()
+    {
+        size_t lru = shadowHits_[static_cast<size_t>(AdaptivePolicy::LRU)];
+        size_t lfu = shadowHits_[static_cast<size_t>(AdaptivePolicy::LFU)];
+        size_t arc = shadowHits_[static_cast<size_t>(AdaptivePolicy::ARC)];
+        size_t fifo = shadowHits_[static_cast<size_t>(AdaptivePolicy::FIFO)];
+
+        AdaptivePolicy leader = lfu > lru ? AdaptivePolicy::LFU : AdaptivePolicy::LRU;
+        size_t best = std::max(lru, lfu);
+        if (arc > best + window_ / 32)
+        {
+            leader = AdaptivePolicy::ARC;
+        }
+        else if (fifo > best)
+        {
+            leader = AdaptivePolicy::FIFO;
+        }
+
+        static constexpr double TARGET[POLICY_COUNT] = {0.0, 1.0, 0.5, 0.0};
+        leader_ = leader;
+        double target = TARGET[static_cast<size_t>(leader)];
+        lfuWeight_ = std::abs(lfuWeight_ - target) < 1.0 / 32 ? target : (lfuWeight_ + target) / 2;
+        shadowHits_.fill(0);
+        sampledAccesses_ = 0;
+    }
+
+    // 命中：移到 LRU 头部，频次加一（需持锁调用）
+    void touch(uint32_t i)
+    {
+        recency_.moveToFront(pool_.data(), i);
+
+        uint32_t bucket = pool_[i].bucket;
+        size_t freq = buckets_[bucket].freq + 1;
+        uint32_t next = buckets_[bucket].link.next;
+        if (next == NIL_INDEX || buckets_[next].freq != freq)
+        {
+            next = insertBucketAfter(bucket, freq);
+        }
+        unlinkFreq(i);
+        linkFreq(next, i);
+    }
+
+    // 新 key 频次为 1，满了先按权重淘汰一个（需持锁调用）
+    void insert(const Key& key, const Value& value)
+    {
+        if (index_.size() >= capacity_) evict();
+
+        uint32_t i = pool_.acquire();
+        Node& node = pool_[i];
+        node.key = key;
+        node.value = value;
+        recency_.pushFront(pool_.data(), i);
+
+        uint32_t bucket = freqBuckets_.head;
+        if (bucket == NIL_INDEX || buckets_[bucket].freq != 1)
+        {
+            bucket = insertBucketAfter(NIL_INDEX, 1);
+        }
+        linkFreq(bucket, i);
+        index_.emplace(key, i);
+    }
+
+    void evict()
+    {
+        uint32_t victim = nextRandom() < lfuWeight_
+            ? buckets_[freqBuckets_.head].entries.tail
+            : recency_.tail;
+
+        recency_.unlink(pool_.data(), victim);
+        unlinkFreq(victim);
+        Node& node = pool_[victim];
+        index_.erase(node.key);
+        node.value = Value{};
+        pool_.release(victim);
+    }
+
+    // xorshift64，[0, 1) 均匀分布
+    double nextRandom()
+    {
+        random_ ^= random_ << 13;
+        random_ ^= random_ >> 7;
+        random_ ^= random_ << 17;
+        return (random_ >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // 在 prev 之后插入新的频次桶，prev 为 NIL_INDEX 时插到链表头
+    uint32_t insertBucketAfter(uint32_t prev, size_t freq)
+    {
+        uint32_t bucket = buckets_.acquire();
+        buckets_[bucket].freq = freq;
+        buckets_[bucket].entries = FreqList();
+        freqBuckets_.insertAfter(buckets_.data(), prev, bucket);
+        return bucket;
+    }
+
+    void linkFreq(uint32_t bucket, uint32_t i)
+    {
+        pool_[i].bucket = bucket;
+        buckets_[bucket].entries.pushFront(pool_.data(), i);
+    }
+
+    // 从所在频次桶摘下，桶空了就归还
+    void unlinkFreq(uint32_t i)
+    {
+        uint32_t bucket = pool_[i].bucket;
+        buckets_[bucket].entries.unlink(pool_.data(), i);
+        pool_[i].bucket = NIL_INDEX;
+        if (buckets_[bucket].entries.empty())
+        {
+            freqBuckets_.unlink(buckets_.data(), bucket);
+            buckets_.release(bucket);
+        }
+    }
+
+private:
+    size_t capacity_;
+    int sampleShift_;
+    size_t window_;
+    NodePool<Node> pool_;        // capacity 个节点，后续不再分配
+    NodePool<Bucket> buckets_;   // 不同频次最多 capacity 个，多一个给“先建新桶再删旧桶”的瞬间
+    Index index_;                // key -> 节点下标
+    RecencyList recency_;        // head 为最近访问
+    BucketList freqBuckets_;     // 按频次升序，head 为最低频次
+    LRUCache<Key, bool> shadowLru_;
+    LFUCache<Key, bool> shadowLfu_;
+    ArcCache<Key, bool> shadowArc_;
+    FIFOCache<Key, bool> shadowFifo_;
+    std::array<size_t, POLICY_COUNT> shadowHits_;  // 当前窗口内各影子的命中数
+    size_t sampledAccesses_;
+    double lfuWeight_;
+    AdaptivePolicy leader_;
+    uint64_t random_;
+    std::mutex mutex_;
+};
+
+} // namespace CacheDemo
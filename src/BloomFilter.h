@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include "HashUtil.h"
+
+namespace CacheDemo
+{
+
+// 计数布隆过滤器（分块）：每个 key 的 4 个计数器落在同一个 64 字节块内，查询只读一个缓存行。
+// mayContain 无锁，可与写入并发；add/remove/reset 由调用方互斥（通常在缓存分片锁内）。
+// 计数器饱和后不再递减，只会多报存在，不会漏报
+template<typename Key>
+class CountingBloomFilter
+{
+private:
+    static constexpr size_t HASHES = 4;
+    static constexpr size_t BLOCK_SIZE = 64;
+    static constexpr uint8_t SATURATED = UINT8_MAX;
+
+    struct alignas(64) Block
+    {
+        std::atomic<uint8_t> counters[BLOCK_SIZE];
+    };
+
+public:
+    // expected: 预计同时存在的 key 数，按每个 key 8 个计数器分配，假阳性率约 3%
+    explicit CountingBloomFilter(size_t expected)
+        : blockMask_(roundUpPow2(std::max<size_t>(1, expected * 8 / BLOCK_SIZE)) - 1),
+          blocks_(new Block[blockMask_ + 1])
+    {
+        reset();
+    }
+
+    CountingBloomFilter(const CountingBloomFilter&) = delete;
+    CountingBloomFilter& operator=(const CountingBloomFilter&) = delete;
+
+    // 返回 false 时 key 一定不存在
+    bool mayContain(const Key& key) const
+    {
+        uint64_t hash = mixHash(std::hash<Key>()(key));
+        const Block& block = blocks_[hash & blockMask_];
+        for (size_t i = 0; i < HASHES; ++i)
+        {
+            if (block.counters[slotOf(hash, i)].load(std::memory_order_relaxed) == 0) return false;
+        }
+        return true;
+    }
+
+    void add(const Key& key)
+    {
+        uint64_t hash = mixHash(std::hash<Key>()(key));
+        Block& block = blocks_[hash & blockMask_];
+        for (size_t i = 0; i < HASHES; ++i)
+        {
+            std::atomic<uint8_t>& counter = block.counters[slotOf(hash, i)];
+            uint8_t count = counter.load(std::memory_order_relaxed);
+            if (count != SATURATED) counter.store(count + 1, std::memory_order_relaxed);
+        }
+    }
+
+    // 只能移除之前 add 过的 key
+    void remove(const Key& key)
+    {
+        uint64_t hash = mixHash(std::hash<Key>()(key));
+        Block& block = blocks_[hash & blockMask_];
+        for (size_t i = 0; i < HASHES; ++i)
+        {
+            std::atomic<uint8_t>& counter = block.counters[slotOf(hash, i)];
+            uint8_t count = counter.load(std::memory_order_relaxed);
+            if (count != SATURATED && count != 0) counter.store(count - 1, std::memory_order_relaxed);
+        }
+    }
+
+    void reset()
+    {
+        for (size_t b = 0; b <= blockMask_; ++b)
+        {
+            for (auto& counter : blocks_[b].counters)
+            {
+                counter.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    // 块号用低位，块内位置依次取高位的 6 位
+    static size_t slotOf(uint64_t hash, size_t i)
+    {
+        return (hash >> (64 - 6 * (i + 1))) & (BLOCK_SIZE - 1);
+    }
+
+private:
+    size_t blockMask_;
+    std::unique_ptr<Block[]> blocks_;
+};
+
+} // namespace CacheDemo
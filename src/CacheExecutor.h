@@ -0,0 +1,108 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace CacheDemo
+{
+
+// 每攒够多少个被淘汰节点才提交一次后台任务
+constexpr size_t RETIRE_BATCH = 64;
+
+// 缓存维护执行器：
+// 淘汰节点的析构、ghost 表维护、频率衰减等维护工作投递到这里，
+// 由后台线程批量执行，把这些开销从 put 的临界区中移走
+class CacheExecutor
+{
+public:
+    CacheExecutor()
+        : stop_(false), running_(0),
+          worker_([this]() { run(); })
+    {}
+
+    ~CacheExecutor()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cond_.notify_all();
+        worker_.join();
+    }
+
+    CacheExecutor(const CacheExecutor&) = delete;
+    CacheExecutor& operator=(const CacheExecutor&) = delete;
+
+    void post(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        cond_.notify_one();
+    }
+
+    // 阻塞直到当前已投递的任务全部执行完
+    // 缓存析构前需要调用，避免后台任务访问已销毁的对象
+    void flush()
+    {
+        if (std::this_thread::get_id() == worker_.get_id()) return;
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this]() { return tasks_.empty() && running_ == 0; });
+    }
+
+private:
+    void run()
+    {
+        std::vector<std::function<void()>> batch;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true)
+        {
+            cond_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+            if (tasks_.empty() && stop_) break;
+
+            // 一次取走全部任务，批量执行
+            batch.swap(tasks_);
+            running_ = batch.size();
+            lock.unlock();
+
+            for (auto& task : batch)
+            {
+                task();
+            }
+            batch.clear();
+
+            lock.lock();
+            running_ = 0;
+            if (tasks_.empty()) idle_.notify_all();
+        }
+        idle_.notify_all();
+    }
+
+private:
+    bool stop_;
+    size_t running_;  // 正在执行的批次大小
+    std::vector<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::condition_variable idle_;
+    std::thread worker_;  // 必须最后初始化
+};
+
+// 把从缓存中整体换出的旧结构交给执行器在后台析构；
+// executor 为空时随本函数返回在调用线程析构，调用方需保证此时已不持有缓存锁
+template<typename... Garbage>
+void releaseLater(CacheExecutor* executor, Garbage... garbage)
+{
+    if (executor == nullptr) return;
+    auto bundle = std::make_shared<std::tuple<Garbage...>>(std::move(garbage)...);
+    executor->post([bundle = std::move(bundle)]() mutable { bundle.reset(); });
+}
+
+} // namespace CacheDemo
@@ -1,12 +1,23 @@
 #pragma once
 
+#include <cstddef>
+#include <functional>
+
 namespace CacheDemo
 {
 
+// 在线调整容量时，每次持锁最多淘汰的节点数，避免长时间占用分片锁
+constexpr size_t RESIZE_STEP = 64;
+
 template<typename Key, typename Value>
 class Cachepolicy
 {
 public:
+    // 参数为旧值，key 不存在时为 nullptr，返回要写入的新值
+    using ComputeFn = std::function<Value(const Value*)>;
+    // 参数为旧值，返回要写入的新值
+    using UpdateFn = std::function<Value(const Value&)>;
+
     virtual ~Cachepolicy() = default;
 
     // 添加缓存接口
@@ -15,6 +26,25 @@ public:
     // 添加查询接口,支持传出参数方式,查询成功返回true
     virtual bool get(const Key& key, Value& value) = 0;
 
+    // 清空缓存：持锁只交换出旧结构，旧数据在锁外（或后台线程）整体释放，不发布移除事件
+    virtual void clear() = 0;
+
+    // 读-改-写操作：各策略须在自己的锁（或等价的原子机制）内一次完成，
+    // 不提供 get + put 组合的默认实现，避免未覆盖的策略悄悄丢失更新。
+    // compareAndSet 要求 Value 支持 ==
+
+    // 用旧值（可能不存在）计算新值并写入，返回新值
+    virtual Value compute(const Key& key, const ComputeFn& fn) = 0;
+
+    // 仅在 key 存在时用旧值计算新值并写入，返回 key 是否存在
+    virtual bool computeIfPresent(const Key& key, const UpdateFn& fn) = 0;
+
+    // key 不存在时写入，返回是否写入
+    virtual bool putIfAbsent(const Key& key, const Value& value) = 0;
+
+    // 当前值等于 expected 时替换为 desired，返回是否替换
+    virtual bool compareAndSet(const Key& key, const Value& expected, const Value& desired) = 0;
+
 };
 
 } // namespace CacheDemo
@@ -0,0 +1,331 @@
+#pragma once
+
+#include <algorithm>
+#include <list>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "Cachepolicy.h"
+#include "LZCodec.h"
+
+namespace CacheDemo
+{
+
+// 值压缩的 LRU：容量按字节计，链表分为热段和冷段，两段首尾相接就是完整的 LRU 顺序。
+// 新写入和被访问的条目放在热段头部，热段超出 hotRatio 份额时尾部降入冷段头部，
+// 此时不小于 threshold 字节且能压下去 1/8 以上的值被压缩；淘汰从冷段尾部开始。
+// 冷段命中时直接解压到调用方的字符串中，条目回到热段并保存原文。
+// 压缩后仍超过总预算的值不写入（同 key 的旧值一并移除），不会为它清空整个缓存。
+// 压缩和解压都在锁内进行，多线程时可通过 ShardedCache 分片
+template<typename Key, typename Codec = LZCodec>
+class CompressedLRUCache : public Cachepolicy<Key, std::string>
+{
+private:
+    struct Node
+    {
+        Key key;
+        std::string data;    // 原文或压缩后的数据
+        bool compressed;
+        bool hot;
+    };
+
+    using Listtype = std::pmr::list<Node>;
+    using ListIterator = typename Listtype::iterator;
+    using Hashmap = std::pmr::unordered_map<Key, ListIterator>;
+
+public:
+    using ComputeFn = typename Cachepolicy<Key, std::string>::ComputeFn;
+    using UpdateFn = typename Cachepolicy<Key, std::string>::UpdateFn;
+
+    // 每个条目除值以外的大致开销（链表节点、索引节点、字符串头），计入容量
+    static constexpr size_t ENTRY_OVERHEAD = sizeof(Node) + sizeof(Key) + 4 * sizeof(void*);
+
+    // capacityBytes: 总字节预算；hotRatio: 热段（不压缩）占预算的比例；
+    // threshold: 小于该长度的值不压缩；resource 用于链表节点和索引
+    explicit CompressedLRUCache(size_t capacityBytes, double hotRatio = 0.25, size_t threshold = 256,
+                                std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : capacity_(capacityBytes),
+          hotCapacity_(static_cast<size_t>(capacityBytes * std::min(1.0, std::max(0.0, hotRatio)))),
+          threshold_(threshold),
+          hot_(resource),
+          cold_(resource),
+          index_(resource),
+          bytes_(0),
+          hotBytes_(0),
+          compressedCount_(0)
+    {}
+
+    ~CompressedLRUCache() override = default;
+
+    void put(const Key& key, const std::string& value) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (!fits(value))
+        {
+            if (it != index_.end()) remove(it->second);
+            return;
+        }
+        if (it != index_.end())
+        {
+            storeRaw(it->second, value);
+            promote(it->second);
+        }
+        else
+        {
+            insert(key, value);
+        }
+        shrink();
+    }
+
+    bool get(const Key& key, std::string& value) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end()) return false;
+
+        ListIterator node = it->second;
+        if (!load(node, value)) return false;
+        if (node->compressed) storeRaw(node, value);
+        promote(node);
+        shrink();
+        return true;
+    }
+
+    std::string get(const Key& key)
+    {
+        std::string value;
+        get(key, value);
+        return value;
+    }
+
+    // 以下读-改-写操作一次加锁完成，fn 在锁内执行，不能再访问本缓存
+    std::string compute(const Key& key, const ComputeFn& fn) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::string value;
+        auto it = index_.find(key);
+        if (it != index_.end() && load(it->second, value))
+        {
+            value = fn(&value);
+            if (!fits(value))
+            {
+                remove(it->second);
+                return value;
+            }
+            storeRaw(it->second, value);
+            promote(it->second);
+        }
+        else
+        {
+            value = fn(nullptr);
+            if (it != index_.end()) remove(it->second);
+            if (!fits(value)) return value;
+            insert(key, value);
+        }
+        shrink();
+        return value;
+    }
+
+    bool computeIfPresent(const Key& key, const UpdateFn& fn) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        std::string value;
+        if (it == index_.end() || !load(it->second, value)) return false;
+
+        value = fn(value);
+        if (!fits(value))
+        {
+            remove(it->second);
+            return true;
+        }
+        storeRaw(it->second, value);
+        promote(it->second);
+        shrink();
+        return true;
+    }
+
+    bool putIfAbsent(const Key& key, const std::string& value) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (index_.find(key) != index_.end() || !fits(value)) return false;
+        insert(key, value);
+        shrink();
+        return true;
+    }
+
+    bool compareAndSet(const Key& key, const std::string& expected, const std::string& desired) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end() || !load(it->second, scratch_) || scratch_ != expected) return false;
+
+        if (!fits(desired))
+        {
+            remove(it->second);
+            return true;
+        }
+        storeRaw(it->second, desired);
+        promote(it->second);
+        shrink();
+        return true;
+    }
+
+    // 持锁交换出链表和索引，锁外释放
+    void clear() override
+    {
+        Listtype hot(hot_.get_allocator());
+        Listtype cold(cold_.get_allocator());
+        Hashmap index(index_.get_allocator());
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            hot.swap(hot_);
+            cold.swap(cold_);
+            index.swap(index_);
+            bytes_ = hotBytes_ = compressedCount_ = 0;
+        }
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    size_t size()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return index_.size();
+    }
+
+    // 当前占用的字节数（含每条目的固定开销）
+    size_t bytes()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return bytes_;
+    }
+
+    size_t compressedCount()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return compressedCount_;
+    }
+
+private:
+    static size_t chargeOf(const Node& node) { return node.data.size() + ENTRY_OVERHEAD; }
+
+    // 原文或压缩后能放进总预算才写入，否则不为它淘汰任何条目（需持锁调用）
+    bool fits(const std::string& value)
+    {
+        if (value.size() + ENTRY_OVERHEAD <= capacity_) return true;
+        if (value.size() < threshold_) return false;
+        Codec::compress(value.data(), value.size(), scratch_);
+        return scratch_.size() <= value.size() - value.size() / 8 && scratch_.size() + ENTRY_OVERHEAD <= capacity_;
+    }
+
+    // 读出原文，压缩的条目解压到 value（需持锁调用）
+    bool load(ListIterator node, std::string& value)
+    {
+        if (!node->compressed)
+        {
+            value = node->data;
+            return true;
+        }
+        return Codec::decompress(node->data.data(), node->data.size(), value);
+    }
+
+    // 以原文保存新值，更新字节计数（需持锁调用）
+    void storeRaw(ListIterator node, const std::string& value)
+    {
+        uncharge(*node);
+        if (node->compressed) --compressedCount_;
+        node->data = value;
+        node->compressed = false;
+        charge(*node);
+    }
+
+    void charge(const Node& node)
+    {
+        bytes_ += chargeOf(node);
+        if (node.hot) hotBytes_ += chargeOf(node);
+    }
+
+    void uncharge(const Node& node)
+    {
+        bytes_ -= chargeOf(node);
+        if (node.hot) hotBytes_ -= chargeOf(node);
+    }
+
+    void insert(const Key& key, const std::string& value)
+    {
+        hot_.push_front(Node{key, value, false, true});
+        charge(hot_.front());
+        index_.emplace(key, hot_.begin());
+    }
+
+    // 移到热段头部（需持锁调用）
+    void promote(ListIterator node)
+    {
+        if (node->hot)
+        {
+            hot_.splice(hot_.begin(), hot_, node);
+            return;
+        }
+        hot_.splice(hot_.begin(), cold_, node);
+        node->hot = true;
+        hotBytes_ += chargeOf(*node);
+    }
+
+    void remove(ListIterator node)
+    {
+        uncharge(*node);
+        if (node->compressed) --compressedCount_;
+        index_.erase(node->key);
+        (node->hot ? hot_ : cold_).erase(node);
+    }
+
+    // 热段超额时尾部降入冷段并尝试压缩，总量超额时从 LRU 末端淘汰（需持锁调用）
+    void shrink()
+    {
+        while (hotBytes_ > hotCapacity_ && !hot_.empty())
+        {
+            ListIterator node = std::prev(hot_.end());
+            cold_.splice(cold_.begin(), hot_, node);
+            hotBytes_ -= chargeOf(*node);
+            node->hot = false;
+            compress(node);
+        }
+        while (bytes_ > capacity_ && !index_.empty())
+        {
+            remove(cold_.empty() ? std::prev(hot_.end()) : std::prev(cold_.end()));
+        }
+    }
+
+    void compress(ListIterator node)
+    {
+        if (node->compressed || node->data.size() < threshold_) return;
+
+        Codec::compress(node->data.data(), node->data.size(), scratch_);
+        if (scratch_.size() > node->data.size() - node->data.size() / 8) return;
+
+        uncharge(*node);
+        node->data.assign(scratch_.data(), scratch_.size());
+        node->data.shrink_to_fit();
+        node->compressed = true;
+        ++compressedCount_;
+        charge(*node);
+    }
+
+private:
+    size_t capacity_;
+    size_t hotCapacity_;
+    size_t threshold_;
+    Listtype hot_;         // head 为最近访问
+    Listtype cold_;        // head 紧接在热段尾部之后
+    Hashmap index_;
+    size_t bytes_;
+    size_t hotBytes_;
+    size_t compressedCount_;
+    std::string scratch_;  // 压缩输出缓冲，复用以减少分配
+    std::mutex mutex_;
+};
+
+} // namespace CacheDemo
@@ -0,0 +1,475 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+#include "Cachepolicy.h"
+#include "IndexList.h"
+
+namespace CacheDemo
+{
+
+// 整数 key 在 [0, KeySpace) 内时的下标，超出范围（含负数）返回 KeySpace
+template<size_t KeySpace, typename Key>
+size_t denseIndexOf(Key key)
+{
+    auto index = static_cast<typename std::make_unsigned<Key>::type>(key);
+    return index < KeySpace ? static_cast<size_t>(index) : KeySpace;
+}
+
+// 稠密整数 key 的 LRU：key 直接作为下标查 slotOf_ 得到槽位，不计算哈希、索引不分配节点；
+// 槽位的 key、value 和 LRU 前后链接分别存放在平行数组中。
+// KeySpace 在编译期声明，范围外的 key 写入被忽略、查询总是未命中
+template<typename Key, typename Value, size_t KeySpace>
+class DenseLRUCache : public Cachepolicy<Key, Value>
+{
+    static_assert(std::is_integral<Key>::value && !std::is_same<Key, bool>::value,
+                  "DenseLRUCache 只适用于整数 key");
+
+public:
+    using ComputeFn = typename Cachepolicy<Key, Value>::ComputeFn;
+    using UpdateFn = typename Cachepolicy<Key, Value>::UpdateFn;
+
+    // 容量超过 KeySpace 没有意义，按 KeySpace 截断
+    explicit DenseLRUCache(size_t capacity)
+        : capacity_(std::min(capacity, KeySpace)),
+          slotOf_(KeySpace, NIL_INDEX),
+          keys_(capacity_),
+          values_(capacity_),
+          prev_(capacity_, NIL_INDEX),
+          next_(capacity_, NIL_INDEX)
+    {}
+
+    ~DenseLRUCache() override = default;
+
+    void put(const Key& key, const Value& value) override
+    {
+        size_t index = denseIndexOf<KeySpace>(key);
+        if (index == KeySpace || capacity_ == 0) return;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t slot = slotOf_[index];
+        if (slot != NIL_INDEX)
+        {
+            values_[slot] = value;
+            moveToFront(slot);
+            return;
+        }
+        insert(index, key, value);
+    }
+
+    bool get(const Key& key, Value& value) override
+    {
+        size_t index = denseIndexOf<KeySpace>(key);
+        if (index == KeySpace) return false;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t slot = slotOf_[index];
+        if (slot == NIL_INDEX) return false;
+
+        value = values_[slot];
+        moveToFront(slot);
+        return true;
+    }
+
+    Value get(const Key& key)
+    {
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    // 以下读-改-写操作一次加锁完成，fn 在锁内执行，不能再访问本缓存
+    Value compute(const Key& key, const ComputeFn& fn) override
+    {
+        size_t index = denseIndexOf<KeySpace>(key);
+        if (index == KeySpace) return fn(nullptr);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t slot = slotOf_[index];
+        if (slot != NIL_INDEX)
+        {
+            values_[slot] = fn(&values_[slot]);
+            moveToFront(slot);
+            return values_[slot];
+        }
+        Value value = fn(nullptr);
+        if (capacity_ > 0) insert(index, key, value);
+        return value;
+    }
+
+    bool computeIfPresent(const Key& key, const UpdateFn& fn) override
+    {
+        size_t index = denseIndexOf<KeySpace>(key);
+        if (index == KeySpace) return false;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t slot = slotOf_[index];
+        if (slot == NIL_INDEX) return false;
+
+        values_[slot] = fn(values_[slot]);
+        moveToFront(slot);
+        return true;
+    }
+
+    bool putIfAbsent(const Key& key, const Value& value) override
+    {
+        size_t index = denseIndexOf<KeySpace>(key);
+        if (index == KeySpace || capacity_ == 0) return false;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (slotOf_[index] != NIL_INDEX) return false;
+        insert(index, key, value);
+        return true;
+    }
+
+    bool compareAndSet(const Key& key, const Value& expected, const Value& desired) override
+    {
+        size_t index = denseIndexOf<KeySpace>(key);
+        if (index == KeySpace) return false;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t slot = slotOf_[index];
+        if (slot == NIL_INDEX || !(values_[slot] == expected)) return false;
+
+        values_[slot] = desired;
+        moveToFront(slot);
+        return true;
+    }
+
+    // 新的下标表和值数组在锁外分配好，持锁只做交换，旧数据在锁外释放
+    void clear() override
+    {
+        std::vector<uint32_t> slotOf(KeySpace, NIL_INDEX);
+        std::vector<Value> values(capacity_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            slotOf.swap(slotOf_);
+            values.swap(values_);
+            head_ = tail_ = NIL_INDEX;
+            size_ = 0;
+        }
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    size_t size()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return size_;
+    }
+
+private:
+    // 未满时按顺序取新槽位，满了复用链表尾部的槽位（需持锁调用）
+    void insert(size_t index, const Key& key, const Value& value)
+    {
+        uint32_t slot;
+        if (size_ < capacity_)
+        {
+            slot = static_cast<uint32_t>(size_++);
+        }
+        else
+        {
+            slot = tail_;
+            unlink(slot);
+            slotOf_[denseIndexOf<KeySpace>(keys_[slot])] = NIL_INDEX;
+        }
+        keys_[slot] = key;
+        values_[slot] = value;
+        slotOf_[index] = slot;
+        pushFront(slot);
+    }
+
+    void moveToFront(uint32_t slot)
+    {
+        if (head_ == slot) return;
+        unlink(slot);
+        pushFront(slot);
+    }
+
+    void pushFront(uint32_t slot)
+    {
+        prev_[slot] = NIL_INDEX;
+        next_[slot] = head_;
+        if (head_ != NIL_INDEX) prev_[head_] = slot; else tail_ = slot;
+        head_ = slot;
+    }
+
+    void unlink(uint32_t slot)
+    {
+        if (prev_[slot] != NIL_INDEX) next_[prev_[slot]] = next_[slot]; else head_ = next_[slot];
+        if (next_[slot] != NIL_INDEX) prev_[next_[slot]] = prev_[slot]; else tail_ = prev_[slot];
+    }
+
+private:
+    size_t capacity_;
+    std::vector<uint32_t> slotOf_;  // key -> 槽位，NIL_INDEX 表示不在缓存中
+    std::vector<Key> keys_;         // 以下按槽位下标的平行数组
+    std::vector<Value> values_;
+    std::vector<uint32_t> prev_;    // LRU 链表，head 最近访问
+    std::vector<uint32_t> next_;
+    uint32_t head_ = NIL_INDEX;
+    uint32_t tail_ = NIL_INDEX;
+    size_t size_ = 0;
+    std::mutex mutex_;
+};
+
+// 稠密整数 key 的 LFU：索引同 DenseLRUCache；与 LFUCache 相同的 O(1) 结构，
+// 槽位按频次挂在频次桶的链表上，频次桶按频次升序串成链表，桶本身也用平行数组存放。
+// 淘汰最小频次中最久未访问的条目，行为与 LFUCache 一致
+template<typename Key, typename Value, size_t KeySpace>
+class DenseLFUCache : public Cachepolicy<Key, Value>
+{
+    static_assert(std::is_integral<Key>::value && !std::is_same<Key, bool>::value,
+                  "DenseLFUCache 只适用于整数 key");
+
+public:
+    using ComputeFn = typename Cachepolicy<Key, Value>::ComputeFn;
+    using UpdateFn = typename Cachepolicy<Key, Value>::UpdateFn;
+
+    explicit DenseLFUCache(size_t capacity)
+        : capacity_(std::min(capacity, KeySpace)),
+          slotOf_(KeySpace, NIL_INDEX),
+          keys_(capacity_),
+          values_(capacity_),
+          bucketOf_(capacity_, NIL_INDEX),
+          prev_(capacity_, NIL_INDEX),
+          next_(capacity_, NIL_INDEX),
+          // 不同频次最多 capacity 个，多留一个给“先建新桶再删旧桶”的瞬间
+          bucketFreq_(capacity_ + 1),
+          bucketHead_(capacity_ + 1, NIL_INDEX),
+          bucketTail_(capacity_ + 1, NIL_INDEX),
+          bucketPrev_(capacity_ + 1, NIL_INDEX),
+          bucketNext_(capacity_ + 1, NIL_INDEX)
+    {
+        resetFreeBuckets();
+    }
+
+    ~DenseLFUCache() override = default;
+
+    void put(const Key& key, const Value& value) override
+    {
+        size_t index = denseIndexOf<KeySpace>(key);
+        if (index == KeySpace || capacity_ == 0) return;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t slot = slotOf_[index];
+        if (slot != NIL_INDEX)
+        {
+            values_[slot] = value;
+            increaseFrequency(slot);
+            return;
+        }
+        insert(index, key, value);
+    }
+
+    bool get(const Key& key, Value& value) override
+    {
+        size_t index = denseIndexOf<KeySpace>(key);
+        if (index == KeySpace) return false;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t slot = slotOf_[index];
+        if (slot == NIL_INDEX) return false;
+
+        value = values_[slot];
+        increaseFrequency(slot);
+        return true;
+    }
+
+    Value get(const Key& key)
+    {
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    // 以下读-改-写操作一次加锁完成，fn 在锁内执行，不能再访问本缓存
+    Value compute(const Key& key, const ComputeFn& fn) override
+    {
+        size_t index = denseIndexOf<KeySpace>(key);
+        if (index == KeySpace) return fn(nullptr);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t slot = slotOf_[index];
+        if (slot != NIL_INDEX)
+        {
+            values_[slot] = fn(&values_[slot]);
+            increaseFrequency(slot);
+            return values_[slot];
+        }
+        Value value = fn(nullptr);
+        if (capacity_ > 0) insert(index, key, value);
+        return value;
+    }
+
+    bool computeIfPresent(const Key& key, const UpdateFn& fn) override
+    {
+        size_t index = denseIndexOf<KeySpace>(key);
+        if (index == KeySpace) return false;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t slot = slotOf_[index];
+        if (slot == NIL_INDEX) return false;
+
+        values_[slot] = fn(values_[slot]);
+        increaseFrequency(slot);
+        return true;
+    }
+
+    bool putIfAbsent(const Key& key, const Value& value) override
+    {
+        size_t index = denseIndexOf<KeySpace>(key);
+        if (index == KeySpace || capacity_ == 0) return false;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (slotOf_[index] != NIL_INDEX) return false;
+        insert(index, key, value);
+        return true;
+    }
+
+    bool compareAndSet(const Key& key, const Value& expected, const Value& desired) override
+    {
+        size_t index = denseIndexOf<KeySpace>(key);
+        if (index == KeySpace) return false;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t slot = slotOf_[index];
+        if (slot == NIL_INDEX || !(values_[slot] == expected)) return false;
+
+        values_[slot] = desired;
+        increaseFrequency(slot);
+        return true;
+    }
+
+    // 新的下标表和值数组在锁外分配好，持锁只做交换，旧数据在锁外释放
+    void clear() override
+    {
+        std::vector<uint32_t> slotOf(KeySpace, NIL_INDEX);
+        std::vector<Value> values(capacity_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            slotOf.swap(slotOf_);
+            values.swap(values_);
+            minBucket_ = NIL_INDEX;
+            size_ = 0;
+            resetFreeBuckets();
+        }
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    size_t size()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return size_;
+    }
+
+private:
+    void resetFreeBuckets()
+    {
+        freeBuckets_.clear();
+        for (size_t b = bucketFreq_.size(); b > 0; --b)
+        {
+            freeBuckets_.push_back(static_cast<uint32_t>(b - 1));
+        }
+    }
+
+    // 新 key 频次为 1；满了先淘汰最小频次桶的尾部（需持锁调用）
+    void insert(size_t index, const Key& key, const Value& value)
+    {
+        uint32_t slot;
+        if (size_ < capacity_)
+        {
+            slot = static_cast<uint32_t>(size_++);
+        }
+        else
+        {
+            slot = bucketTail_[minBucket_];
+            slotOf_[denseIndexOf<KeySpace>(keys_[slot])] = NIL_INDEX;
+            unlinkSlot(slot);
+        }
+        keys_[slot] = key;
+        values_[slot] = value;
+        slotOf_[index] = slot;
+
+        uint32_t bucket = minBucket_;
+        if (bucket == NIL_INDEX || bucketFreq_[bucket] != 1)
+        {
+            bucket = insertBucketAfter(NIL_INDEX, 1);
+        }
+        pushFront(bucket, slot);
+    }
+
+    // 频次加一：移到下一个频次桶头部，没有该频次的桶就紧挨着新建一个（需持锁调用）
+    void increaseFrequency(uint32_t slot)
+    {
+        uint32_t bucket = bucketOf_[slot];
+        size_t freq = bucketFreq_[bucket] + 1;
+        uint32_t next = bucketNext_[bucket];
+        if (next == NIL_INDEX || bucketFreq_[next] != freq)
+        {
+            next = insertBucketAfter(bucket, freq);
+        }
+        unlinkSlot(slot);
+        pushFront(next, slot);
+    }
+
+    uint32_t insertBucketAfter(uint32_t prev, size_t freq)
+    {
+        uint32_t bucket = freeBuckets_.back();
+        freeBuckets_.pop_back();
+        bucketFreq_[bucket] = freq;
+        bucketHead_[bucket] = bucketTail_[bucket] = NIL_INDEX;
+        bucketPrev_[bucket] = prev;
+        bucketNext_[bucket] = prev != NIL_INDEX ? bucketNext_[prev] : minBucket_;
+        if (bucketNext_[bucket] != NIL_INDEX) bucketPrev_[bucketNext_[bucket]] = bucket;
+        if (prev != NIL_INDEX) bucketNext_[prev] = bucket; else minBucket_ = bucket;
+        return bucket;
+    }
+
+    void pushFront(uint32_t bucket, uint32_t slot)
+    {
+        bucketOf_[slot] = bucket;
+        prev_[slot] = NIL_INDEX;
+        next_[slot] = bucketHead_[bucket];
+        if (bucketHead_[bucket] != NIL_INDEX) prev_[bucketHead_[bucket]] = slot; else bucketTail_[bucket] = slot;
+        bucketHead_[bucket] = slot;
+    }
+
+    // 从所在频次桶摘下，桶空了就删除桶
+    void unlinkSlot(uint32_t slot)
+    {
+        uint32_t bucket = bucketOf_[slot];
+        if (prev_[slot] != NIL_INDEX) next_[prev_[slot]] = next_[slot]; else bucketHead_[bucket] = next_[slot];
+        if (next_[slot] != NIL_INDEX) prev_[next_[slot]] = prev_[slot]; else bucketTail_[bucket] = prev_[slot];
+        if (bucketHead_[bucket] != NIL_INDEX) return;
+
+        if (bucketPrev_[bucket] != NIL_INDEX) bucketNext_[bucketPrev_[bucket]] = bucketNext_[bucket];
+        else minBucket_ = bucketNext_[bucket];
+        if (bucketNext_[bucket] != NIL_INDEX) bucketPrev_[bucketNext_[bucket]] = bucketPrev_[bucket];
+        freeBuckets_.push_back(bucket);
+    }
+
+private:
+    size_t capacity_;
+    std::vector<uint32_t> slotOf_;  // key -> 槽位，NIL_INDEX 表示不在缓存中
+    std::vector<Key> keys_;         // 以下按槽位下标的平行数组
+    std::vector<Value> values_;
+    std::vector<uint32_t> bucketOf_;
+    std::vector<uint32_t> prev_;    // 同频次链表，head 最新访问
+    std::vector<uint32_t> next_;
+    std::vector<size_t> bucketFreq_;  // 以下按频次桶下标的平行数组
+    std::vector<uint32_t> bucketHead_;
+    std::vector<uint32_t> bucketTail_;
+    std::vector<uint32_t> bucketPrev_;  // 频次桶链表，按频次升序
+    std::vector<uint32_t> bucketNext_;
+    std::vector<uint32_t> freeBuckets_;
+    uint32_t minBucket_ = NIL_INDEX;
+    size_t size_ = 0;
+    std::mutex mutex_;
+};
+
+} // namespace CacheDemo
@@ -0,0 +1,495 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "HashUtil.h"
+
+namespace CacheDemo
+{
+
+// 基于纪元（epoch）的内存回收：
+// 读者进入临界区时只做一次普通 store + 内存屏障来宣告自己看到的纪元，没有原子 RMW；
+// 写者摘下的节点先 retire，等全局纪元前进两次（所有读者都离开旧纪元）后才真正释放
+class EpochManager
+{
+private:
+    struct Retired
+    {
+        void* ptr;
+        void (*deleter)(void*);
+    };
+
+    // 每个线程一条记录，local 为 0 表示不在临界区
+    struct alignas(64) ThreadRecord
+    {
+        std::atomic<uint64_t> local{0};
+        std::atomic<bool> inUse{false};
+        ThreadRecord* next = nullptr;
+        unsigned nesting = 0;
+        size_t retireCount = 0;
+        // 以下只由持有该记录的线程访问
+        std::vector<Retired> limbo[3];
+        uint64_t limboEpoch[3] = {0, 0, 0};
+    };
+
+    // 所有线程记录与孤儿节点，线程退出时记录还回这里
+    struct Domain
+    {
+        const uint64_t id = nextDomainId();  // 永不复用，线程侧按它识别 domain
+        std::atomic<uint64_t> epoch{1};
+        std::atomic<ThreadRecord*> head{nullptr};
+        std::mutex orphanMutex;
+        std::vector<Retired> orphans;  // 已退出线程留下、尚未释放的节点
+
+        ~Domain()
+        {
+            // 没有任何线程还能访问这些节点了
+            ThreadRecord* rec = head.load();
+            while (rec != nullptr)
+            {
+                ThreadRecord* next = rec->next;
+                for (auto& bucket : rec->limbo)
+                {
+                    freeAll(bucket);
+                }
+                delete rec;
+                rec = next;
+            }
+            freeAll(orphans);
+        }
+    };
+
+public:
+    // 每攒够多少次 retire 尝试推进一次纪元
+    static constexpr size_t ADVANCE_INTERVAL = 64;
+
+    EpochManager() : domain_(std::make_shared<Domain>()) {}
+
+    EpochManager(const EpochManager&) = delete;
+    EpochManager& operator=(const EpochManager&) = delete;
+
+    // 读端临界区，支持嵌套
+    class Guard
+    {
+    public:
+        explicit Guard(ThreadRecord* rec) : rec_(rec) {}
+
+        Guard(Guard&& other) noexcept : rec_(other.rec_) { other.rec_ = nullptr; }
+
+        ~Guard()
+        {
+            if (rec_ != nullptr && --rec_->nesting == 0)
+            {
+                rec_->local.store(0, std::memory_order_release);
+            }
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+    private:
+        ThreadRecord* rec_;
+    };
+
+    Guard pin()
+    {
+        ThreadRecord* rec = localRecord();
+        if (rec->nesting++ == 0)
+        {
+            rec->local.store(domain_->epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            // 宣告必须先于之后对共享指针的读取对写者可见
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+        return Guard(rec);
+    }
+
+    // 节点已从共享结构中摘除后调用，宽限期过后由 deleter 释放
+    template<typename T>
+    void retire(T* ptr)
+    {
+        retire(static_cast<void*>(ptr), [](void* p) { delete static_cast<T*>(p); });
+    }
+
+    void retire(void* ptr, void (*deleter)(void*))
+    {
+        ThreadRecord* rec = localRecord();
+        uint64_t epoch = domain_->epoch.load(std::memory_order_acquire);
+        size_t slot = epoch % 3;
+        if (rec->limboEpoch[slot] != epoch)
+        {
+            // 该槽里是至少三个纪元之前的节点，可以直接释放
+            freeAll(rec->limbo[slot]);
+            rec->limboEpoch[slot] = epoch;
+        }
+        rec->limbo[slot].push_back(Retired{ptr, deleter});
+
+        if (++rec->retireCount % ADVANCE_INTERVAL == 0)
+        {
+            tryAdvance();
+            reclaim(rec);
+        }
+    }
+
+    // 尝试推进全局纪元：所有处于临界区的线程都已看到当前纪元时才能推进
+    bool tryAdvance()
+    {
+        uint64_t epoch = domain_->epoch.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        for (ThreadRecord* rec = domain_->head.load(std::memory_order_acquire); rec != nullptr; rec = rec->next)
+        {
+            uint64_t local = rec->local.load(std::memory_order_acquire);
+            if (local != 0 && local != epoch) return false;
+        }
+        return domain_->epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_acq_rel);
+    }
+
+private:
+    static void freeAll(std::vector<Retired>& bucket)
+    {
+        for (auto& r : bucket)
+        {
+            r.deleter(r.ptr);
+        }
+        bucket.clear();
+    }
+
+    // 释放本线程中已过宽限期（纪元落后两个以上）的节点
+    void reclaim(ThreadRecord* rec)
+    {
+        uint64_t epoch = domain_->epoch.load(std::memory_order_acquire);
+        for (size_t i = 0; i < 3; ++i)
+        {
+            if (!rec->limbo[i].empty() && rec->limboEpoch[i] + 2 <= epoch)
+            {
+                freeAll(rec->limbo[i]);
+            }
+        }
+
+        std::vector<Retired> orphans;
+        {
+            std::unique_lock<std::mutex> lock(domain_->orphanMutex, std::try_to_lock);
+            if (!lock.owns_lock() || domain_->orphans.empty()) return;
+            orphans.swap(domain_->orphans);
+        }
+        // 孤儿节点的纪元未知，重新挂到当前纪元等待下一轮
+        size_t slot = epoch % 3;
+        if (rec->limboEpoch[slot] != epoch)
+        {
+            freeAll(rec->limbo[slot]);
+            rec->limboEpoch[slot] = epoch;
+        }
+        rec->limbo[slot].insert(rec->limbo[slot].end(), orphans.begin(), orphans.end());
+    }
+
+    static uint64_t nextDomainId()
+    {
+        static std::atomic<uint64_t> id(0);
+        return id.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    // 线程侧只弱引用 domain：domain 随最后一个 EpochManager 销毁时连同线程记录一起释放，
+    // 线程退出时归还仍存活 domain 的记录，未释放的节点交给 domain
+    struct LocalEntry
+    {
+        uint64_t id;
+        std::weak_ptr<Domain> domain;
+        ThreadRecord* rec;  // 仅在 id 对应的 domain 存活时有效
+    };
+
+    struct LocalRecords
+    {
+        std::vector<LocalEntry> entries;
+
+        ~LocalRecords()
+        {
+            for (auto& entry : entries)
+            {
+                std::shared_ptr<Domain> domain = entry.domain.lock();
+                if (!domain) continue;
+                {
+                    std::lock_guard<std::mutex> lock(domain->orphanMutex);
+                    for (auto& bucket : entry.rec->limbo)
+                    {
+                        domain->orphans.insert(domain->orphans.end(), bucket.begin(), bucket.end());
+                        bucket.clear();
+                    }
+                }
+                entry.rec->local.store(0, std::memory_order_release);
+                entry.rec->nesting = 0;
+                entry.rec->inUse.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    // 按 id 查找，命中路径没有原子 RMW；调用方持有 domain_，id 相同即说明记录仍有效。
+    // 新登记时顺带清掉已销毁 domain 的条目，列表长度只与仍存活的 domain 数有关
+    ThreadRecord* localRecord()
+    {
+        thread_local LocalRecords records;
+        uint64_t id = domain_->id;
+        for (auto& entry : records.entries)
+        {
+            if (entry.id == id) return entry.rec;
+        }
+
+        auto& entries = records.entries;
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                     [](const LocalEntry& entry) { return entry.domain.expired(); }),
+                      entries.end());
+        ThreadRecord* rec = acquireRecord();
+        entries.push_back(LocalEntry{id, domain_, rec});
+        return rec;
+    }
+
+    // 复用已退出线程的记录，没有则新建并挂到链表头
+    ThreadRecord* acquireRecord()
+    {
+        for (ThreadRecord* rec = domain_->head.load(std::memory_order_acquire); rec != nullptr; rec = rec->next)
+        {
+            bool expected = false;
+            if (!rec->inUse.load(std::memory_order_relaxed) &&
+                rec->inUse.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+            {
+                return rec;
+            }
+        }
+
+        ThreadRecord* rec = new ThreadRecord();
+        rec->inUse.store(true, std::memory_order_relaxed);
+        ThreadRecord* head = domain_->head.load(std::memory_order_relaxed);
+        do
+        {
+            rec->next = head;
+        } while (!domain_->head.compare_exchange_weak(head, rec, std::memory_order_release, std::memory_order_relaxed));
+        return rec;
+    }
+
+private:
+    std::shared_ptr<Domain> domain_;
+};
+
+// 读无锁的并发哈希索引：
+// 桶数在构造时固定；写操作按桶分条加锁，节点一旦发布就不再修改，
+// 更新时换成新节点，旧节点经 EpochManager 宽限期后释放。
+// 命中路径只有一次纪元宣告和若干 acquire 读
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class ConcurrentHashIndex
+{
+private:
+    struct Node
+    {
+        Key key;
+        Value value;
+        std::atomic<Node*> next;
+
+        Node(const Key& k, const Value& v, Node* n) : key(k), value(v), next(n) {}
+    };
+
+    static constexpr size_t LOCK_STRIPES = 64;
+
+public:
+    explicit ConcurrentHashIndex(size_t capacity, std::shared_ptr<EpochManager> epoch = nullptr)
+        : epoch_(epoch ? std::move(epoch) : std::make_shared<EpochManager>()),
+          mask_(roundUpPow2(capacity < 16 ? 16 : capacity) - 1),
+          buckets_(new std::atomic<Node*>[mask_ + 1]),
+          locks_(new std::mutex[LOCK_STRIPES]),
+          size_(0)
+    {
+        for (size_t i = 0; i <= mask_; ++i)
+        {
+            buckets_[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~ConcurrentHashIndex()
+    {
+        for (size_t i = 0; i <= mask_; ++i)
+        {
+            Node* node = buckets_[i].load(std::memory_order_relaxed);
+            while (node != nullptr)
+            {
+                Node* next = node->next.load(std::memory_order_relaxed);
+                delete node;
+                node = next;
+            }
+        }
+    }
+
+    ConcurrentHashIndex(const ConcurrentHashIndex&) = delete;
+    ConcurrentHashIndex& operator=(const ConcurrentHashIndex&) = delete;
+
+    bool find(const Key& key, Value& value) const
+    {
+        auto guard = epoch_->pin();
+        const Node* node = lookup(key);
+        if (node == nullptr) return false;
+        value = node->value;
+        return true;
+    }
+
+    // 在临界区内对找到的值调用 fn，避免拷贝
+    template<typename Fn>
+    bool visit(const Key& key, Fn&& fn) const
+    {
+        auto guard = epoch_->pin();
+        const Node* node = lookup(key);
+        if (node == nullptr) return false;
+        fn(node->value);
+        return true;
+    }
+
+    bool contains(const Key& key) const
+    {
+        auto guard = epoch_->pin();
+        return lookup(key) != nullptr;
+    }
+
+    // 插入或覆盖，返回 true 表示新插入；覆盖时旧值通过 old 传出
+    bool insertOrAssign(const Key& key, const Value& value, Value* old = nullptr)
+    {
+        size_t bucket = bucketOf(key);
+        std::lock_guard<std::mutex> lock(locks_[bucket % LOCK_STRIPES]);
+
+        std::atomic<Node*>* link = &buckets_[bucket];
+        for (Node* node = link->load(std::memory_order_relaxed); node != nullptr;
+             node = link->load(std::memory_order_relaxed))
+        {
+            if (node->key == key)
+            {
+                if (old != nullptr) *old = node->value;
+                Node* fresh = new Node(key, value, node->next.load(std::memory_order_relaxed));
+                link->store(fresh, std::memory_order_release);
+                epoch_->retire(node);
+                return false;
+            }
+            link = &node->next;
+        }
+
+        Node* head = buckets_[bucket].load(std::memory_order_relaxed);
+        buckets_[bucket].store(new Node(key, value, head), std::memory_order_release);
+        size_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 在桶锁内读-改-写：fn(current, next) 中 current 为当前值，key 不存在时为 nullptr；
+    // fn 返回 true 时写入 next（覆盖时换成新节点，旧节点经宽限期释放），返回是否写入。
+    // fn 在桶锁内执行，不能再访问本索引
+    template<typename Fn>
+    bool update(const Key& key, Fn&& fn)
+    {
+        size_t bucket = bucketOf(key);
+        std::lock_guard<std::mutex> lock(locks_[bucket % LOCK_STRIPES]);
+
+        std::atomic<Node*>* link = &buckets_[bucket];
+        for (Node* node = link->load(std::memory_order_relaxed); node != nullptr;
+             node = link->load(std::memory_order_relaxed))
+        {
+            if (node->key == key)
+            {
+                Value next;
+                if (!fn(static_cast<const Value*>(&node->value), next)) return false;
+                Node* fresh = new Node(key, next, node->next.load(std::memory_order_relaxed));
+                link->store(fresh, std::memory_order_release);
+                epoch_->retire(node);
+                return true;
+            }
+            link = &node->next;
+        }
+
+        Value next;
+        if (!fn(static_cast<const Value*>(nullptr), next)) return false;
+        Node* head = buckets_[bucket].load(std::memory_order_relaxed);
+        buckets_[bucket].store(new Node(key, next, head), std::memory_order_release);
+        size_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 仅当 key 不存在时插入
+    bool insert(const Key& key, const Value& value)
+    {
+        size_t bucket = bucketOf(key);
+        std::lock_guard<std::mutex> lock(locks_[bucket % LOCK_STRIPES]);
+
+        Node* head = buckets_[bucket].load(std::memory_order_relaxed);
+        for (Node* node = head; node != nullptr; node = node->next.load(std::memory_order_relaxed))
+        {
+            if (node->key == key) return false;
+        }
+        buckets_[bucket].store(new Node(key, value, head), std::memory_order_release);
+        size_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool erase(const Key& key)
+    {
+        return eraseImpl(key, nullptr);
+    }
+
+    // 仅当当前值等于 expected 时删除，用于避免误删已被覆盖的新值
+    bool erase(const Key& key, const Value& expected)
+    {
+        return eraseImpl(key, &expected);
+    }
+
+    size_t size() const { return size_.load(std::memory_order_relaxed); }
+
+    EpochManager& epoch() const { return *epoch_; }
+
+private:
+    bool eraseImpl(const Key& key, const Value* expected)
+    {
+        size_t bucket = bucketOf(key);
+        std::lock_guard<std::mutex> lock(locks_[bucket % LOCK_STRIPES]);
+
+        std::atomic<Node*>* link = &buckets_[bucket];
+        for (Node* node = link->load(std::memory_order_relaxed); node != nullptr;
+             node = link->load(std::memory_order_relaxed))
+        {
+            if (node->key == key)
+            {
+                if (expected != nullptr && !(node->value == *expected)) return false;
+                link->store(node->next.load(std::memory_order_relaxed), std::memory_order_release);
+                epoch_->retire(node);
+                size_.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+            link = &node->next;
+        }
+        return false;
+    }
+
+    const Node* lookup(const Key& key) const
+    {
+        const Node* node = buckets_[bucketOf(key)].load(std::memory_order_acquire);
+        while (node != nullptr && !(node->key == key))
+        {
+            node = node->next.load(std::memory_order_acquire);
+        }
+        return node;
+    }
+
+    size_t bucketOf(const Key& key) const
+    {
+        // 混合一下高位，避免 std::hash<int> 恒等映射时只用到低位
+        size_t h = Hash()(key);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return h & mask_;
+    }
+
+private:
+    std::shared_ptr<EpochManager> epoch_;
+    size_t mask_;
+    std::unique_ptr<std::atomic<Node*>[]> buckets_;
+    std::unique_ptr<std::mutex[]> locks_;
+    std::atomic<size_t> size_;
+};
+
+} // namespace CacheDemo
@@ -1,6 +1,7 @@
 #pragma once
 
 #include<list>
+#include<memory_resource>
 #include<memory>
 #include<unordered_map>
 #include<mutex>
@@ -15,11 +16,15 @@ class FIFOCache : public Cachepolicy<Key, Value>
 
 public:
     using Nodetype = std::pair<Key,Value>; 
-    using Listtype = std::list<Nodetype>;
+    using Listtype = std::pmr::list<Nodetype>;
     using ListIterator = typename Listtype::iterator;
-    using Hashmap = std::unordered_map<Key, ListIterator>;
+    using Hashmap = std::pmr::unordered_map<Key, ListIterator>;
+    using ComputeFn = typename Cachepolicy<Key, Value>::ComputeFn;
+    using UpdateFn = typename Cachepolicy<Key, Value>::UpdateFn;
 
-    explicit  FIFOCache(size_t cap):capacity_(cap) 
+    // resource 用于链表节点和哈希表，默认使用全局默认内存资源
+    explicit  FIFOCache(size_t cap, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : capacity_(cap), Cachelist_(resource), Cachemap_(resource)
     {
         Cachemap_.reserve(cap); 
     }
@@ -32,20 +37,58 @@ public:
 
         std::lock_guard<std::mutex> lock(fifomutex_);
 
-        auto it = Cachemap_.find(key);
-        if(it != Cachemap_.end()){
-            it->second->second = value;
+        auto slot = Cachemap_.try_emplace(key);
+        if(!slot.second){
+            slot.first->second->second = value;
             return;
         }
+        linkLocked(slot.first, value);
+    }
 
-        if(Cachelist_.size() >= capacity_){
-            auto tail = Cachelist_.back();
-            Cachemap_.erase(tail.first);
-            Cachelist_.pop_back();
+    // 以下读-改-写操作都只加一次锁；FIFO 更新不改变入队顺序。
+    // key 不存在时先算出新值再占位，fn 抛异常不会在映射表里留下半成品
+    Value compute(const Key& key, const ComputeFn& fn) override
+    {
+        std::lock_guard<std::mutex> lock(fifomutex_);
+        if(capacity_ == 0) return fn(nullptr);
+
+        auto it = Cachemap_.find(key);
+        if(it != Cachemap_.end()){
+            Value& current = it->second->second;
+            current = fn(&current);
+            return current;
         }
+        Value value = fn(nullptr);
+        linkLocked(Cachemap_.try_emplace(key).first, value);
+        return value;
+    }
+
+    bool computeIfPresent(const Key& key, const UpdateFn& fn) override
+    {
+        std::lock_guard<std::mutex> lock(fifomutex_);
+        auto it = Cachemap_.find(key);
+        if(it == Cachemap_.end()) return false;
+        it->second->second = fn(it->second->second);
+        return true;
+    }
+
+    bool putIfAbsent(const Key& key, const Value& value) override
+    {
+        if(capacity_ == 0) return false;
+        std::lock_guard<std::mutex> lock(fifomutex_);
+        auto slot = Cachemap_.try_emplace(key);
+        if(!slot.second) return false;
+        linkLocked(slot.first, value);
+        return true;
+    }
 
-        Cachelist_.push_front({key, value});
-        Cachemap_[key] = Cachelist_.begin();
+    bool compareAndSet(const Key& key, const Value& expected, const Value& desired) override
+    {
+        std::lock_guard<std::mutex> lock(fifomutex_);
+        auto it = Cachemap_.find(key);
+        if(it == Cachemap_.end() || !(it->second->second == expected)) return false;
+        it->second->second = desired;
+        return true;
     }
 
     bool get(const Key& key, Value& value) override
@@ -61,6 +104,19 @@ public:
         return true;
 
     }
+    void clear() override
+    {
+        Listtype list(Cachelist_.get_allocator());
+        Hashmap map(Cachemap_.get_allocator());
+        map.reserve(capacity_);
+        {
+            std::lock_guard<std::mutex> lock(fifomutex_);
+            list.swap(Cachelist_);
+            map.swap(Cachemap_);
+        }
+        // 旧节点在锁外析构
+    }
+
     void deletenode(const Key& key){
         std::lock_guard<std::mutex> lock(fifomutex_);
 
@@ -74,6 +130,19 @@ public:
 
     }
 
+private:
+    // 映射表中已为新 key 占位，满了先淘汰最早入队的节点（需持锁调用）
+    void linkLocked(typename Hashmap::iterator slot, const Value& value)
+    {
+        if(Cachelist_.size() >= capacity_){
+            Cachemap_.erase(Cachelist_.back().first);
+            Cachelist_.pop_back();
+        }
+
+        Cachelist_.push_front({slot->first, value});
+        slot->second = Cachelist_.begin();
+    }
+
 private:
     /* data */
     size_t capacity_;
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace CacheDemo
+{
+
+// 不小于 n 的最小 2 的幂，n 为 0 时返回 1
+inline size_t roundUpPow2(size_t n)
+{
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+// splitmix64 的终结函数。std::hash 对整数是恒等映射，按位取桶、抽样或作指纹前先用它打散
+inline uint64_t mixHash(uint64_t x)
+{
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+} // namespace CacheDemo
@@ -0,0 +1,258 @@
+#pragma once
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "EpochReclaim.h"
+#include "LRUCache.h"
+
+namespace CacheDemo
+{
+
+// Space-Saving 热点统计：只保留 k 个计数器，
+// 新 key 在计数器已满时顶替计数最小的那个，并继承其计数（误差上界）
+template<typename Key>
+class SpaceSaving
+{
+public:
+    explicit SpaceSaving(size_t k) : k_(k > 0 ? k : 1)
+    {
+        counters_.reserve(k_);
+        index_.reserve(k_);
+    }
+
+    void record(const Key& key)
+    {
+        auto it = index_.find(key);
+        if (it != index_.end())
+        {
+            ++counters_[it->second].second;
+            return;
+        }
+
+        if (counters_.size() < k_)
+        {
+            index_[key] = counters_.size();
+            counters_.emplace_back(key, 1);
+            return;
+        }
+
+        // k 较小，线性找最小计数即可
+        size_t minPos = 0;
+        for (size_t i = 1; i < counters_.size(); ++i)
+        {
+            if (counters_[i].second < counters_[minPos].second) minPos = i;
+        }
+        index_.erase(counters_[minPos].first);
+        counters_[minPos].first = key;
+        ++counters_[minPos].second;
+        index_[key] = minPos;
+    }
+
+    // 按计数从高到低返回当前统计到的 key
+    std::vector<std::pair<Key, size_t>> topK() const
+    {
+        std::vector<std::pair<Key, size_t>> result(counters_);
+        std::sort(result.begin(), result.end(),
+                  [](const std::pair<Key, size_t>& a, const std::pair<Key, size_t>& b) { return a.second > b.second; });
+        return result;
+    }
+
+    // 计数减半，让统计跟随访问分布的变化
+    void decay()
+    {
+        for (auto& counter : counters_)
+        {
+            counter.second /= 2;
+        }
+    }
+
+private:
+    size_t k_;
+    std::vector<std::pair<Key, size_t>> counters_;  // {key, 计数}
+    std::unordered_map<Key, size_t> index_;          // key -> counters_ 下标
+};
+
+// 带热点复制的分片 LRU：
+// 采样访问喂给 Space-Saving，识别出的热点 key 复制到一份读无锁的副本中，
+// 副本是 ConcurrentHashIndex，读热点 key 时不经过分片锁，被覆盖的旧值经纪元宽限期后回收。
+// 副本中某个 key 的插入、更新都在该 key 所在分片的锁内完成，保证副本与分片一致
+template<typename Key, typename Value>
+class HotKeyHashLRUCache
+{
+public:
+    // topK: 最多复制的热点数; sampleRate: 每多少次 get 采样一次; refreshSamples: 采样多少次后刷新热点集合
+    HotKeyHashLRUCache(size_t capacity, int sliceNum, size_t topK = 32,
+                       size_t sampleRate = 16, size_t refreshSamples = 4096)
+        : shards_(capacity, sliceNum),
+          sketch_(topK * 2),
+          topK_(topK),
+          sampleRate_(sampleRate > 0 ? sampleRate : 1),
+          refreshSamples_(refreshSamples > 0 ? refreshSamples : 1),
+          samples_(0),
+          replica_(topK * 2)
+    {}
+
+    HotKeyHashLRUCache(const HotKeyHashLRUCache&) = delete;
+    HotKeyHashLRUCache& operator=(const HotKeyHashLRUCache&) = delete;
+
+    // 副本命中也要采样，否则已复制的热点计数衰减后被换出，热点集合来回抖动；
+    // 被采样的 get 照常走分片，刷新热点在分片 LRU 中的位置，否则它们只在副本中被读而先被分片淘汰
+    bool get(const Key& key, Value& value)
+    {
+        if (!sample(key) && replica_.find(key, value)) return true;
+        return shards_.get(key, value);
+    }
+
+    Value get(const Key& key)
+    {
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    // 写热点 key 时只在分片锁内替换副本中这一个条目，热点应当是读多写少的
+    void put(const Key& key, const Value& value)
+    {
+        shards_.put(key, value);
+        if (isHot(key)) syncReplica(key);
+    }
+
+    // 读-改-写在分片锁内完成，改到热点 key 时同步副本
+    Value compute(const Key& key, const typename LRUCache<Key, Value>::ComputeFn& fn)
+    {
+        Value value = shards_.compute(key, fn);
+        if (isHot(key)) syncReplica(key);
+        return value;
+    }
+
+    bool computeIfPresent(const Key& key, const typename LRUCache<Key, Value>::UpdateFn& fn)
+    {
+        if (!shards_.computeIfPresent(key, fn)) return false;
+        if (isHot(key)) syncReplica(key);
+        return true;
+    }
+
+    // 热点 key 可能已被分片淘汰而仍留在副本中，写入成功后同样要同步
+    bool putIfAbsent(const Key& key, const Value& value)
+    {
+        if (!shards_.putIfAbsent(key, value)) return false;
+        if (isHot(key)) syncReplica(key);
+        return true;
+    }
+
+    bool compareAndSet(const Key& key, const Value& expected, const Value& desired)
+    {
+        if (!shards_.compareAndSet(key, expected, desired)) return false;
+        if (isHot(key)) syncReplica(key);
+        return true;
+    }
+
+    // 清空分片并移除全部副本
+    void clear()
+    {
+        shards_.clear();
+        std::lock_guard<std::mutex> lock(refreshMutex_);
+        for (auto& key : hotSet_)
+        {
+            replica_.erase(key);
+        }
+        hotSet_.clear();
+    }
+
+    bool isHot(const Key& key) const
+    {
+        return replica_.contains(key);
+    }
+
+    std::vector<Key> hotKeys()
+    {
+        std::lock_guard<std::mutex> lock(refreshMutex_);
+        std::vector<Key> keys;
+        for (auto& key : hotSet_)
+        {
+            if (replica_.contains(key)) keys.push_back(key);
+        }
+        return keys;
+    }
+
+private:
+    // 返回这次访问是否被采样
+    bool sample(const Key& key)
+    {
+        thread_local size_t tick = 0;
+        if (++tick % sampleRate_ != 0) return false;
+
+        // 采样失败无所谓，拿不到锁直接跳过，不让统计本身成为热点
+        std::unique_lock<std::mutex> lock(sketchMutex_, std::try_to_lock);
+        if (!lock.owns_lock()) return true;
+
+        sketch_.record(key);
+        if (++samples_ < refreshSamples_) return true;
+        samples_ = 0;
+
+        std::vector<std::pair<Key, size_t>> top = sketch_.topK();
+        sketch_.decay();
+        lock.unlock();
+
+        // 只复制占采样明显比例的 key，均匀分布时不复制
+        std::vector<Key> keys;
+        size_t threshold = refreshSamples_ / (topK_ * 4) + 1;
+        for (auto& entry : top)
+        {
+            if (keys.size() >= topK_ || entry.second < threshold) break;
+            keys.push_back(entry.first);
+        }
+        refresh(std::move(keys));
+        return true;
+    }
+
+    // 换入新的热点集合：逐个 key 增删副本，每次只持有该 key 所在分片的锁，
+    // 读者始终可以无锁访问副本，不需要等待宽限期
+    void refresh(std::vector<Key> keys)
+    {
+        std::lock_guard<std::mutex> lock(refreshMutex_);
+        for (auto& key : hotSet_)
+        {
+            if (std::find(keys.begin(), keys.end(), key) != keys.end()) continue;
+            // 与 syncReplica 在同一把分片锁内互斥，避免刚删掉又被写回；
+            // peekWith 只读，不改变 LRU 顺序，也不会发布 Replaced 事件
+            bool present = shards_.peekWith(key, [this, &key](const Value&) { replica_.erase(key); });
+            if (!present) replica_.erase(key);
+        }
+        for (auto& key : keys)
+        {
+            if (!shards_.peekWith(key, [this, &key](const Value& value) { replica_.insertOrAssign(key, value); }))
+            {
+                replica_.erase(key);
+            }
+        }
+        hotSet_.swap(keys);
+    }
+
+    // 在分片锁内把副本更新为分片中的最新值，并发写同一个 key 时最后一次同步读到的一定是最后写入的值；
+    // key 已被分片淘汰时移除副本，删除只会少一次加速，不会读到旧值
+    void syncReplica(const Key& key)
+    {
+        bool present = shards_.peekWith(key, [this, &key](const Value& value) {
+            if (replica_.contains(key)) replica_.insertOrAssign(key, value);
+        });
+        if (!present) replica_.erase(key);
+    }
+
+private:
+    HashLRUCache<Key, Value> shards_;
+    SpaceSaving<Key> sketch_;
+    size_t topK_;
+    size_t sampleRate_;
+    size_t refreshSamples_;
+    size_t samples_;               // 自上次刷新以来的采样数，受 sketchMutex_ 保护
+    std::vector<Key> hotSet_;      // 当前热点 key，受 refreshMutex_ 保护
+    ConcurrentHashIndex<Key, Value> replica_;  // 热点 key 的只读副本
+    std::mutex sketchMutex_;
+    std::mutex refreshMutex_;
+};
+
+} // namespace CacheDemo
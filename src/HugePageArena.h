@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <sys/mman.h>
+#include <vector>
+
+namespace CacheDemo
+{
+
+// 以 2MB 大页为后备的上游内存资源：大量条目时链表节点和哈希桶分散在很多 4KB 页上，
+// 查找时的 TLB 未命中占了主要开销，放进大页后同样的内存只需很少的 TLB 项。
+// 先尝试 hugetlbfs（MAP_HUGETLB，需要系统预留大页），失败则按 2MB 对齐 mmap 并
+// madvise(MADV_HUGEPAGE) 请求透明大页，内核不支持时就是普通页，功能不受影响。
+// 小块从 2MB 对齐的区域中顺序切分，释放时不归还，随 arena 析构一起释放，
+// 因此应作为 unsynchronized_pool_resource / synchronized_pool_resource 的上游，由池负责复用；
+// 不小于半个大页的分配单独映射，释放时立即归还（如哈希表扩容换下的旧桶数组）
+class HugePageArena : public std::pmr::memory_resource
+{
+public:
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    // regionSize: 每次为小块映射的区域大小，向上取整为大页的整数倍
+    explicit HugePageArena(size_t regionSize = 16 * HUGE_PAGE_SIZE)
+        : regionSize_(roundUp(std::max(regionSize, HUGE_PAGE_SIZE))),
+          cursor_(nullptr),
+          end_(nullptr),
+          mappedBytes_(0),
+          hugetlbBytes_(0)
+    {}
+
+    HugePageArena(const HugePageArena&) = delete;
+    HugePageArena& operator=(const HugePageArena&) = delete;
+
+    ~HugePageArena() override
+    {
+        for (const Region& region : regions_)
+        {
+            ::munmap(region.addr, region.length);
+        }
+    }
+
+    // 当前映射的字节数，及其中来自 hugetlbfs 的部分（其余为透明大页或普通页）
+    size_t mappedBytes() const { return mappedBytes_.load(std::memory_order_relaxed); }
+    size_t hugetlbBytes() const { return hugetlbBytes_.load(std::memory_order_relaxed); }
+
+private:
+    struct Region
+    {
+        void* addr;
+        size_t length;
+        bool hugetlb;
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        if (alignment > HUGE_PAGE_SIZE) throw std::bad_alloc();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (bytes >= HUGE_PAGE_SIZE / 2)
+        {
+            regions_.push_back(mapRegion(roundUp(bytes)));
+            return regions_.back().addr;
+        }
+
+        uintptr_t p = (reinterpret_cast<uintptr_t>(cursor_) + alignment - 1) & ~(alignment - 1);
+        if (cursor_ == nullptr || p + bytes > reinterpret_cast<uintptr_t>(end_))
+        {
+            // 当前区域剩余部分放弃，换一个新区域
+            regions_.push_back(mapRegion(regionSize_));
+            char* addr = static_cast<char*>(regions_.back().addr);
+            cursor_ = addr;
+            end_ = addr + regionSize_;
+            p = reinterpret_cast<uintptr_t>(cursor_);
+        }
+        cursor_ = reinterpret_cast<char*>(p + bytes);
+        return reinterpret_cast<void*>(p);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t) override
+    {
+        if (bytes < HUGE_PAGE_SIZE / 2) return;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = std::find_if(regions_.begin(), regions_.end(),
+                               [p](const Region& region) { return region.addr == p; });
+        if (it == regions_.end()) return;
+        ::munmap(it->addr, it->length);
+        mappedBytes_.fetch_sub(it->length, std::memory_order_relaxed);
+        if (it->hugetlb) hugetlbBytes_.fetch_sub(it->length, std::memory_order_relaxed);
+        *it = regions_.back();
+        regions_.pop_back();
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    static size_t roundUp(size_t bytes)
+    {
+        return (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    }
+
+    // length 为大页整数倍，返回 2MB 对齐的映射（需持锁调用）
+    Region mapRegion(size_t length)
+    {
+#ifdef MAP_HUGETLB
+        void* addr = ::mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (addr != MAP_FAILED)
+        {
+            mappedBytes_.fetch_add(length, std::memory_order_relaxed);
+            hugetlbBytes_.fetch_add(length, std::memory_order_relaxed);
+            return Region{addr, length, true};
+        }
+#endif
+        // 多映射一个大页，裁掉首尾得到 2MB 对齐的区间，透明大页才能整页生效
+        size_t padded = length + HUGE_PAGE_SIZE;
+        char* raw = static_cast<char*>(::mmap(nullptr, padded, PROT_READ | PROT_WRITE,
+                                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if (raw == MAP_FAILED) throw std::bad_alloc();
+
+        uintptr_t base = reinterpret_cast<uintptr_t>(raw);
+        char* aligned = reinterpret_cast<char*>((base + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1));
+        size_t head = aligned - raw;
+        if (head > 0) ::munmap(raw, head);
+        size_t tail = padded - head - length;
+        if (tail > 0) ::munmap(aligned + length, tail);
+#ifdef MADV_HUGEPAGE
+        ::madvise(aligned, length, MADV_HUGEPAGE);
+#endif
+        mappedBytes_.fetch_add(length, std::memory_order_relaxed);
+        return Region{aligned, length, false};
+    }
+
+private:
+    size_t regionSize_;
+    char* cursor_;                 // 当前小块区域中下一个可用位置
+    char* end_;
+    std::vector<Region> regions_;  // 所有映射，析构时统一归还
+    std::atomic<size_t> mappedBytes_;
+    std::atomic<size_t> hugetlbBytes_;
+    std::mutex mutex_;
+};
+
+} // namespace CacheDemo
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace CacheDemo
+{
+
+constexpr uint32_t NIL_INDEX = UINT32_MAX;
+
+// 节点内的链接字段，用数组下标代替指针
+struct IndexLink
+{
+    uint32_t prev = NIL_INDEX;
+    uint32_t next = NIL_INDEX;
+};
+
+// 预先分配好的节点数组 + 空闲下标栈，取用和归还都不分配内存
+template<typename Node>
+class NodePool
+{
+public:
+    explicit NodePool(size_t size) : nodes_(size)
+    {
+        free_.reserve(size);
+        for (size_t i = size; i > 0; --i)
+        {
+            free_.push_back(static_cast<uint32_t>(i - 1));
+        }
+    }
+
+    // 调用方需保证还有空闲节点
+    uint32_t acquire()
+    {
+        uint32_t i = free_.back();
+        free_.pop_back();
+        return i;
+    }
+
+    // 节点内容由调用方重置
+    void release(uint32_t i) { free_.push_back(i); }
+
+    Node& operator[](uint32_t i) { return nodes_[i]; }
+    Node* data() { return nodes_.data(); }
+    size_t size() const { return nodes_.size(); }
+
+    void swap(NodePool& other)
+    {
+        nodes_.swap(other.nodes_);
+        free_.swap(other.free_);
+    }
+
+private:
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> free_;
+};
+
+// 侵入式双向链表：节点在 NodePool 中，Link 指定使用节点的哪个链接字段，
+// 同一节点可以借不同的链接字段同时挂在多条链表上
+template<typename Node, IndexLink Node::*Link>
+struct IndexList
+{
+    uint32_t head = NIL_INDEX;
+    uint32_t tail = NIL_INDEX;
+    size_t size = 0;
+
+    bool empty() const { return size == 0; }
+
+    void pushFront(Node* nodes, uint32_t i)
+    {
+        IndexLink& link = nodes[i].*Link;
+        link.prev = NIL_INDEX;
+        link.next = head;
+        if (head != NIL_INDEX) (nodes[head].*Link).prev = i; else tail = i;
+        head = i;
+        ++size;
+    }
+
+    void pushBack(Node* nodes, uint32_t i)
+    {
+        IndexLink& link = nodes[i].*Link;
+        link.next = NIL_INDEX;
+        link.prev = tail;
+        if (tail != NIL_INDEX) (nodes[tail].*Link).next = i; else head = i;
+        tail = i;
+        ++size;
+    }
+
+    // 插到 prev 之后，prev 为 NIL_INDEX 时插到头部
+    void insertAfter(Node* nodes, uint32_t prev, uint32_t i)
+    {
+        if (prev == NIL_INDEX)
+        {
+            pushFront(nodes, i);
+            return;
+        }
+        IndexLink& link = nodes[i].*Link;
+        link.prev = prev;
+        link.next = (nodes[prev].*Link).next;
+        if (link.next != NIL_INDEX) (nodes[link.next].*Link).prev = i; else tail = i;
+        (nodes[prev].*Link).next = i;
+        ++size;
+    }
+
+    void unlink(Node* nodes, uint32_t i)
+    {
+        IndexLink& link = nodes[i].*Link;
+        if (link.prev != NIL_INDEX) (nodes[link.prev].*Link).next = link.next; else head = link.next;
+        if (link.next != NIL_INDEX) (nodes[link.next].*Link).prev = link.prev; else tail = link.prev;
+        link.prev = link.next = NIL_INDEX;
+        --size;
+    }
+
+    // 已在本链表中的节点移到头部
+    void moveToFront(Node* nodes, uint32_t i)
+    {
+        if (head == i) return;
+        unlink(nodes, i);
+        pushFront(nodes, i);
+    }
+};
+
+} // namespace CacheDemo
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <list>
+#include <memory_resource>
 #include <cmath>
 #include <vector>
 #include <memory>
@@ -8,6 +11,8 @@
 #include <unordered_map>
 #include <mutex>
 #include "Cachepolicy.h"
+#include "CacheExecutor.h"
+#include "RemovalListener.h"
 
 namespace CacheDemo {
 
@@ -15,110 +20,256 @@ namespace CacheDemo {
 constexpr int MAX_FREQ = 16;
 
 
+// 单索引 LFU：每个 key 只在 cache_ 中存一份，节点内嵌频次桶的双向链接，
+// 频次桶本身按频次升序串成链表（O(1) LFU），链表头即最小频次，
+// 查找只需一次哈希，增加频次只移动指针
 template <typename Key, typename Value>
 class LFUCache : public Cachepolicy<Key, Value> {
-public:
+private:
+    struct FreqBucket;
+    struct Node;
+    using Hashmap = std::pmr::unordered_map<Key, Node>;
+    using Entry = typename Hashmap::value_type;
+
+    struct Node {
+        Value value;
+        FreqBucket* bucket = nullptr;
+        Entry* prev = nullptr;   // 同频次链表，靠近头部的是较新访问的
+        Entry* next = nullptr;
+    };
+
+    // 同一频次的节点链表，head 最新、tail 最旧
+    struct FreqBucket {
+        int freq;
+        Entry* head = nullptr;
+        Entry* tail = nullptr;
+        FreqBucket* prev = nullptr;
+        FreqBucket* next = nullptr;
+
+        explicit FreqBucket(int f) : freq(f) {}
+    };
 
-    // 用于存储相同访问频次的键的双向链表
-    using Listtype = std::list<Key>;
-    // 存储缓存的键值对，同时记录访问频次
-    using Hashmap = std::unordered_map<Key, std::pair<Value, int>>; 
-    // 频次字段映射到对应双向链表，方便o1找到最少使用
-    using Freqmap = std::unordered_map<int, Listtype>; 
-    using ListIterator = typename Listtype::iterator;
-    // 方便o1删除，因为可以直接拿到迭代器
-    using Itermap = std::unordered_map<Key, ListIterator>; 
+public:
+    using ComputeFn = typename Cachepolicy<Key, Value>::ComputeFn;
+    using UpdateFn = typename Cachepolicy<Key, Value>::UpdateFn;
+
+    // resource 用于索引节点、哈希桶和频次桶，默认使用全局默认内存资源。
+    // clear 和后台执行器会在锁外释放节点，多线程使用时 resource 必须线程安全
+    explicit LFUCache(size_t cap, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : capacity_(cap), cache_(resource), minBucket_(nullptr), bucketAlloc_(resource) {
+        cache_.reserve(cap);
+    }
 
-    explicit LFUCache(size_t cap) : capacity_(cap), min_freq_(0) {}
+    ~LFUCache() override {
+        while (minBucket_) {
+            FreqBucket* next = minBucket_->next;
+            deleteBucket(minBucket_);
+            minBucket_ = next;
+        }
+    }
 
-    ~LFUCache() override = default;
+    LFUCache(const LFUCache&) = delete;
+    LFUCache& operator=(const LFUCache&) = delete;
 
     void put(const Key& key, const Value& value) override {
         if (capacity_ == 0) return;
         
         std::lock_guard<std::mutex> lock(LFUmutex_);
 
-        // 如果key已存在，则更新value并增加访问频率
-        if (cache_.count(key)) {
-            cache_[key].first = value;
-            increase_frequency(key);
+        // 一次探测：key 已存在则更新 value 并增加访问频率，否则作为新 key 插入
+        auto slot = cache_.try_emplace(key);
+        if (!slot.second) {
+            assignLocked(&*slot.first, value);
             return;
         }
-
-        // 如果缓存已满，淘汰访问频率最低的 key
-        if (cache_.size() >= capacity_) {
-            Key evict_key = freq_map_[min_freq_].back();
-            freq_map_[min_freq_].pop_back();
-            if (freq_map_[min_freq_].empty()) freq_map_.erase(min_freq_);
-
-            cache_.erase(evict_key);
-            iter_map_.erase(evict_key);
-        }
-
-        // 插入新 key，访问频率设为 1
-        min_freq_ = 1;
-        cache_[key] = {value, 1};
-        freq_map_[1].push_front(key);
-        iter_map_[key] = freq_map_[1].begin();
+        linkLocked(&*slot.first, value);
     }
 
     bool get(const Key& key, Value& value) override {
         std::lock_guard<std::mutex> lock(LFUmutex_);
 
-        if (!cache_.count(key)) return false;
+        auto it = cache_.find(key);
+        if (it == cache_.end()) return false;
 
         // 获取 value
-        value = cache_[key].first;
+        value = it->second.value;
 
-        increase_frequency(key);
+        increase_frequency(&*it);
 
         return true;
     }
 
-    void deletenode(const Key& key) {
+    // 以下读-改-写操作都只加一次锁，fn 在锁内执行，不能再访问本缓存。
+    // key 不存在时先算出新值再占位，fn 抛异常不会在索引里留下半成品
+    Value compute(const Key& key, const ComputeFn& fn) override {
         std::lock_guard<std::mutex> lock(LFUmutex_);
+        if (capacity_ == 0) return fn(nullptr);
+
+        auto it = cache_.find(key);
+        if (it != cache_.end()) {
+            Value value = fn(&it->second.value);
+            assignLocked(&*it, value);
+            return value;
+        }
+        Value value = fn(nullptr);
+        linkLocked(&*cache_.try_emplace(key).first, value);
+        return value;
+    }
 
-        if (!cache_.count(key)) return;
+    bool computeIfPresent(const Key& key, const UpdateFn& fn) override {
+        std::lock_guard<std::mutex> lock(LFUmutex_);
+        auto it = cache_.find(key);
+        if (it == cache_.end()) return false;
+        assignLocked(&*it, fn(it->second.value));
+        return true;
+    }
 
-        int freq = cache_[key].second;
+    bool putIfAbsent(const Key& key, const Value& value) override {
+        if (capacity_ == 0) return false;
+        std::lock_guard<std::mutex> lock(LFUmutex_);
+        auto slot = cache_.try_emplace(key);
+        if (!slot.second) return false;
+        linkLocked(&*slot.first, value);
+        return true;
+    }
 
-        freq_map_[freq].erase(iter_map_[key]);
-        if (freq_map_[freq].empty()) {
-            freq_map_.erase(freq);
-            if (min_freq_ == freq) min_freq_++;
+    bool compareAndSet(const Key& key, const Value& expected, const Value& desired) override {
+        std::lock_guard<std::mutex> lock(LFUmutex_);
+        auto it = cache_.find(key);
+        if (it == cache_.end() || !(it->second.value == expected)) return false;
+        assignLocked(&*it, desired);
+        return true;
+    }
+
+    // 持锁交换出索引和频次桶链表，锁外释放
+    void clear() override {
+        Hashmap cache(cache_.get_allocator());
+        cache.reserve(capacity_);
+        FreqBucket* buckets;
+        {
+            std::lock_guard<std::mutex> lock(LFUmutex_);
+            cache.swap(cache_);
+            buckets = minBucket_;
+            minBucket_ = nullptr;
         }
+        while (buckets) {
+            FreqBucket* next = buckets->next;
+            deleteBucket(buckets);
+            buckets = next;
+        }
+    }
 
-        cache_.erase(key);
-        iter_map_.erase(key);
+    void deletenode(const Key& key) {
+        std::lock_guard<std::mutex> lock(LFUmutex_);
+
+        auto it = cache_.find(key);
+        if (it == cache_.end()) return;
+
+        unlink(&*it);
+        notifyRemoval(key, it->second.value, RemovalCause::Explicit);
+        cache_.erase(it);
+    }
+
+    // 设置移除监听：淘汰/覆盖/删除事件在锁内无锁入队，由分发器线程批量回调
+    void setRemovalListener(std::shared_ptr<RemovalDispatcher<Key, Value>> dispatcher) {
+        std::lock_guard<std::mutex> lock(LFUmutex_);
+        removalDispatcher_ = std::move(dispatcher);
     }
 
 private:
     size_t capacity_;
-    int min_freq_; 
-    // key->(value,freq)
+    // key->节点（value、所在频次桶、桶内链接）
     Hashmap cache_; 
-    // freq->list
-    Freqmap freq_map_; 
-    // key->(list::iterator)
-    Itermap iter_map_; 
+    // 频次最小的桶，也是频次桶链表的头
+    FreqBucket* minBucket_;
+    std::pmr::polymorphic_allocator<FreqBucket> bucketAlloc_;
+    std::shared_ptr<RemovalDispatcher<Key, Value>> removalDispatcher_;
 
     std::mutex LFUmutex_;
 
 private:
-void increase_frequency(const Key& key) {
-    int freq = cache_[key].second;
-    // 从当前频率列表中移除key
-    freq_map_[freq].erase(iter_map_[key]);
-    // 当前频率列表为空，则最小访问次数应该+1
-    if (freq_map_[freq].empty()) {
-        freq_map_.erase(freq);
-        if (min_freq_ == freq) ++min_freq_;
-    }
-    // 增加 key 的访问频率
-    ++freq;
-    cache_[key].second = freq;
-    freq_map_[freq].push_front(key);
-    iter_map_[key] = freq_map_[freq].begin();
+void notifyRemoval(const Key& key, Value& value, RemovalCause cause) {
+    if (removalDispatcher_) {
+        removalDispatcher_->publish(key, std::move(value), cause);
+    }
+}
+
+// 新 key 已在索引中占位：超出容量时先淘汰最低频次桶中最旧的 key，再放入频次 1 的桶
+void linkLocked(Entry* entry, const Value& value) {
+    entry->second.value = value;
+    if (cache_.size() > capacity_) {
+        Entry* victim = minBucket_->tail;
+        unlink(victim);
+        notifyRemoval(victim->first, victim->second.value, RemovalCause::Capacity);
+        cache_.erase(cache_.find(victim->first));
+    }
+
+    FreqBucket* bucket = minBucket_;
+    if (!bucket || bucket->freq != 1) {
+        bucket = insertBucketAfter(nullptr, 1);
+    }
+    pushFront(bucket, entry);
+}
+
+// 更新已有 key 的 value 并增加访问频率，旧值作为覆盖事件发布
+void assignLocked(Entry* entry, const Value& value) {
+    notifyRemoval(entry->first, entry->second.value, RemovalCause::Replaced);
+    entry->second.value = value;
+    increase_frequency(entry);
+}
+
+void deleteBucket(FreqBucket* bucket) {
+    bucket->~FreqBucket();
+    bucketAlloc_.deallocate(bucket, 1);
+}
+
+// 在 prev 之后插入新的频次桶，prev 为空时插到链表头
+FreqBucket* insertBucketAfter(FreqBucket* prev, int freq) {
+    FreqBucket* bucket = bucketAlloc_.allocate(1);
+    new (bucket) FreqBucket(freq);
+    bucket->prev = prev;
+    bucket->next = prev ? prev->next : minBucket_;
+    if (bucket->next) bucket->next->prev = bucket;
+    if (prev) prev->next = bucket; else minBucket_ = bucket;
+    return bucket;
+}
+
+void pushFront(FreqBucket* bucket, Entry* entry) {
+    Node& node = entry->second;
+    node.bucket = bucket;
+    node.prev = nullptr;
+    node.next = bucket->head;
+    if (bucket->head) bucket->head->second.prev = entry; else bucket->tail = entry;
+    bucket->head = entry;
+}
+
+// 从所在桶中摘除，桶空了就连同桶一起删除
+void unlink(Entry* entry) {
+    Node& node = entry->second;
+    FreqBucket* bucket = node.bucket;
+    if (node.prev) node.prev->second.next = node.next; else bucket->head = node.next;
+    if (node.next) node.next->second.prev = node.prev; else bucket->tail = node.prev;
+    node.prev = node.next = nullptr;
+    node.bucket = nullptr;
+
+    if (!bucket->head) {
+        if (bucket->prev) bucket->prev->next = bucket->next; else minBucket_ = bucket->next;
+        if (bucket->next) bucket->next->prev = bucket->prev;
+        deleteBucket(bucket);
+    }
+}
+
+void increase_frequency(Entry* entry) {
+    FreqBucket* bucket = entry->second.bucket;
+    int freq = bucket->freq + 1;
+    // 目标桶不存在时紧接在当前桶之后新建，保持频次有序
+    FreqBucket* target = bucket->next;
+    if (!target || target->freq != freq) {
+        target = insertBucketAfter(bucket, freq);
+    }
+    // 目标桶已就位后再摘除，当前桶被删除也不影响 target
+    unlink(entry);
+    pushFront(target, entry);
 }
 };
 
@@ -128,66 +279,199 @@ struct LRUNode {
   Key key;
   Value value;
   size_t freq;
+  size_t epoch;  // freq 对应的衰减轮次，落后时访问到再补做减半
   
-  LRUNode(Key k, Value v, size_t f = 1)
-      : key(k), value(v), freq(f) {}
+  LRUNode(Key k, Value v, size_t f = 1, size_t e = 0)
+      : key(k), value(v), freq(f), epoch(e) {}
 };
 
 template <typename Key, typename Value>
 class LFUMCache : public Cachepolicy<Key, Value> {
 public:
 
-    using Listtype = std::list<LRUNode<Key, Value>>;
+    using Listtype = std::pmr::list<LRUNode<Key, Value>>;
     using ListIterator = typename Listtype::iterator;
-    using Freqmap = std::unordered_map<size_t, Listtype>;
-    using Cachemap = std::unordered_map<Key, ListIterator>;
-
-    explicit LFUMCache(size_t cap, int max_freq = MAX_FREQ)
-        : capacity_(cap), max_freq_(max_freq), min_freq_(0), put_count_(0) {}
-
-    ~LFUMCache() override = default;
+    using Freqmap = std::pmr::unordered_map<size_t, Listtype>;
+    using Cachemap = std::pmr::unordered_map<Key, ListIterator>;
+
+    // resource 用于节点、索引和频次表，默认使用全局默认内存资源
+    explicit LFUMCache(size_t cap, int max_freq = MAX_FREQ,
+                       std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : capacity_(cap), max_freq_(max_freq), min_freq_(0), cache_(resource), freq_map_(resource),
+          put_count_(0), decay_epoch_(0), retired_(resource) {}
+
+    ~LFUMCache() override {
+        // 已投递的节点批次仍在用本缓存的内存资源，需等它们释放完
+        if (executor_) executor_->flush();
+    }
 
     void put(const Key& key, const Value& value) override {
         if (capacity_ == 0) return;
-        std::lock_guard<std::mutex> lock(LFUmutex_);
+        Listtype garbage(retired_.get_allocator());
+        {
+            std::lock_guard<std::mutex> lock(LFUmutex_);
+            ++access_count_;
 
-        if (cache_.count(key)) {
-            cache_[key]->value = value;
-            
-            increase_frequency(key);
-            return;
-        }
+            auto it = cache_.find(key);
+            if (it != cache_.end()) {
+                assignLocked(it, value);
+                return;
+            }
 
-        if (cache_.size() >= capacity_) {
-            freqDecay();
-            evictLFU();
+            insertLocked(key, value);
+            collectRetired(garbage);
         }
-
-        min_freq_ = 1;
-        freq_map_[1].emplace_front(key, value, 1);
-        cache_[key] = freq_map_[1].begin();
-        put_count_++;
-        
+        releaseRetired(garbage);
     }
 
     bool get(const Key& key, Value& value) override {
         
         std::lock_guard<std::mutex> lock(LFUmutex_);
-        if (!cache_.count(key)) return false;
-        value = cache_[key]->value;
-        increase_frequency(key);
+        ++access_count_;
+        auto it = cache_.find(key);
+        if (it == cache_.end()) return false;
+        value = it->second->value;
+        increase_frequency(it);
         
         return true;
     }
 
+    // 以下读-改-写操作都只加一次锁，fn 在锁内执行，不能再访问本缓存
+    Value compute(const Key& key, const typename Cachepolicy<Key, Value>::ComputeFn& fn) override {
+        Listtype garbage(retired_.get_allocator());
+        Value value;
+        {
+            std::lock_guard<std::mutex> lock(LFUmutex_);
+            ++access_count_;
+
+            auto it = cache_.find(key);
+            if (it != cache_.end()) {
+                value = fn(&it->second->value);
+                assignLocked(it, value);
+                return value;
+            }
+
+            value = fn(nullptr);
+            if (capacity_ > 0) insertLocked(key, value);
+            collectRetired(garbage);
+        }
+        releaseRetired(garbage);
+        return value;
+    }
+
+    bool computeIfPresent(const Key& key, const typename Cachepolicy<Key, Value>::UpdateFn& fn) override {
+        std::lock_guard<std::mutex> lock(LFUmutex_);
+        ++access_count_;
+        auto it = cache_.find(key);
+        if (it == cache_.end()) return false;
+        assignLocked(it, fn(it->second->value));
+        return true;
+    }
+
+    bool putIfAbsent(const Key& key, const Value& value) override {
+        if (capacity_ == 0) return false;
+        Listtype garbage(retired_.get_allocator());
+        {
+            std::lock_guard<std::mutex> lock(LFUmutex_);
+            ++access_count_;
+            if (cache_.find(key) != cache_.end()) return false;
+            insertLocked(key, value);
+            collectRetired(garbage);
+        }
+        releaseRetired(garbage);
+        return true;
+    }
+
+    bool compareAndSet(const Key& key, const Value& expected, const Value& desired) override {
+        std::lock_guard<std::mutex> lock(LFUmutex_);
+        ++access_count_;
+        auto it = cache_.find(key);
+        if (it == cache_.end() || !(it->second->value == expected)) return false;
+        assignLocked(it, desired);
+        return true;
+    }
+
+    // 清空缓存，旧节点有执行器时交给后台线程析构
+    void clear() override {
+        Freqmap freqMap(freq_map_.get_allocator());
+        Cachemap cacheMap(cache_.get_allocator());
+        Listtype retired(retired_.get_allocator());
+        {
+            std::lock_guard<std::mutex> lock(LFUmutex_);
+            freqMap.swap(freq_map_);
+            cacheMap.swap(cache_);
+            retired.swap(retired_);
+            min_freq_ = 0;
+            put_count_ = 0;
+        }
+        releaseLater(executor_.get(), std::move(freqMap), std::move(cacheMap), std::move(retired));
+    }
+
+    // 设置后台维护执行器：淘汰节点的析构改由后台线程执行
+    // 需在缓存投入使用前设置
+    void setExecutor(std::shared_ptr<CacheExecutor> executor) {
+        std::lock_guard<std::mutex> lock(LFUmutex_);
+        executor_ = std::move(executor);
+    }
+
+    // 设置移除监听：淘汰/覆盖事件在锁内无锁入队，由分发器线程批量回调
+    void setRemovalListener(std::shared_ptr<RemovalDispatcher<Key, Value>> dispatcher) {
+        std::lock_guard<std::mutex> lock(LFUmutex_);
+        removalDispatcher_ = std::move(dispatcher);
+    }
+
+    // 在线调整容量：扩容立即生效；缩容时分批淘汰，每批最多 step 个节点，批与批之间释放锁
+    void setCapacity(size_t cap, size_t step = RESIZE_STEP) {
+        capacity_ = cap;
+        if (step == 0) step = 1;
+
+        bool done = false;
+        while (!done) {
+            Listtype garbage(retired_.get_allocator());
+            {
+                std::lock_guard<std::mutex> lock(LFUmutex_);
+                for (size_t n = 0; n < step && cache_.size() > capacity_; ++n) {
+                    evictLFU();
+                }
+                done = cache_.size() <= capacity_;
+                if (retired_.size() >= RETIRE_BATCH) {
+                    garbage.swap(retired_);
+                }
+            }
+            if (!garbage.empty()) {
+                executor_->post([nodes = std::move(garbage)]() mutable { nodes.clear(); });
+            }
+        }
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(LFUmutex_);
+        return cache_.size();
+    }
+
+    // 取出并清零自上次调用以来的访问次数，供分片容量再平衡使用
+    size_t takeAccessCount() {
+        std::lock_guard<std::mutex> lock(LFUmutex_);
+        size_t count = access_count_;
+        access_count_ = 0;
+        return count;
+    }
+
 private:
-    size_t capacity_;
+    std::atomic<size_t> capacity_;
     int max_freq_;
     int min_freq_;
     Cachemap cache_;  //  key->list<node>iterator
     Freqmap freq_map_; // freq->list<node>
     std::mutex LFUmutex_;
     size_t put_count_;
+    size_t decay_epoch_;  // 已做过的衰减轮数
+    size_t access_count_ = 0;  // 访问计数，持锁更新
+    Listtype retired_;    // 等待后台析构的节点
+    std::shared_ptr<CacheExecutor> executor_;
+    std::shared_ptr<RemovalDispatcher<Key, Value>> removalDispatcher_;
 
 private:
     void evictLFU() {
@@ -197,20 +481,34 @@ private:
         Listtype& list = freq_map_[min_freq_];
         // if (list.empty()) return;  // 检查 list 是否为空
     
-        LRUNode<Key, Value> evict_node = list.back();
-    
         // 删除缓存项
-        cache_.erase(evict_node.key);
+        cache_.erase(list.back().key);
+        if (removalDispatcher_) {
+            LRUNode<Key, Value>& node = list.back();
+            removalDispatcher_->publish(std::move(node.key), std::move(node.value), RemovalCause::Capacity);
+        }
     
         // 调试输出
         // std::cout << "Evicting key: " << evict_node.key << std::endl;
     
-        // 弹出尾部元素
-        list.pop_back();
+        // 弹出尾部元素，有执行器时节点转入待回收链表，不在锁内析构
+        if (executor_) {
+            retired_.splice(retired_.end(), list, std::prev(list.end()));
+        } else {
+            list.pop_back();
+        }
     
-        // 如果 list 为空，清除 freq_map 中的对应频率
+        // 如果 list 为空，清除 freq_map 中的对应频率，并重新找到最小频率
+        // 频率不超过 max_freq_，遍历代价很小，保证连续淘汰时 min_freq_ 始终有效
         if (list.empty()) {
             freq_map_.erase(min_freq_);
+            if (!freq_map_.empty()) {
+                size_t min_freq = freq_map_.begin()->first;
+                for (auto& entry : freq_map_) {
+                    min_freq = std::min(min_freq, entry.first);
+                }
+                min_freq_ = static_cast<int>(min_freq);
+            }
         }
     
         // 打印调试信息
@@ -218,50 +516,96 @@ private:
     }
     
 
-    void increase_frequency(const Key& key) {
-        ListIterator node_it = cache_[key];
+    // 节点整体 splice 到新频次链表头，迭代器不变，不需要重写 cache_
+    void increase_frequency(typename Cachemap::iterator it) {
+        ListIterator node_it = it->second;
         
-        size_t freq = node_it->freq;
-        Value value = node_it->value;
-        cache_.erase(key);
+        size_t freq = currentFreq(*node_it);
+        size_t new_freq = std::min(freq + 1, (size_t)max_freq_);
+        // 插入新频次可能 rehash，只持引用
+        Listtype& from = freq_map_[freq];
+        Listtype& to = freq_map_[new_freq];
+        to.splice(to.begin(), from, node_it);
+        node_it->freq = new_freq;
 
-        freq_map_[freq].erase(node_it);
-        if (freq_map_[freq].empty()) {
+        if (from.empty()) {
             freq_map_.erase(freq);
             if (min_freq_ == freq && min_freq_ < max_freq_) {
                 min_freq_++;
             }
         }
-        size_t new_freq = std::min(freq + 1, (size_t)max_freq_);
-        freq_map_[new_freq].emplace_front(key, value, new_freq); 
-        cache_[key] = freq_map_[new_freq].begin();
+    }
+
+    // 插入新 key，满了先衰减再淘汰（需持锁调用）
+    void insertLocked(const Key& key, const Value& value) {
+        if (cache_.size() >= capacity_) {
+            freqDecay();
+            evictLFU();
+        }
+
+        min_freq_ = 1;
+        freq_map_[1].emplace_front(key, value, 1, decay_epoch_);
+        cache_[key] = freq_map_[1].begin();
+        put_count_++;
+    }
+
+    // 更新已有 key 并增加访问频率，旧值作为覆盖事件发布（需持锁调用）
+    void assignLocked(typename Cachemap::iterator it, const Value& value) {
+        ListIterator node = it->second;
+        if (removalDispatcher_) {
+            removalDispatcher_->publish(it->first, std::move(node->value), RemovalCause::Replaced);
+        }
+        node->value = value;
+        increase_frequency(it);
+    }
+
+    // 攒够一批被淘汰节点后整体取走（需持锁调用）
+    void collectRetired(Listtype& garbage) {
+        if (retired_.size() >= RETIRE_BATCH) {
+            garbage.swap(retired_);
+        }
+    }
+
+    // 锁外把整批节点交给后台线程析构
+    void releaseRetired(Listtype& garbage) {
+        if (!garbage.empty()) {
+            executor_->post([nodes = std::move(garbage)]() mutable { nodes.clear(); });
+        }
     }
     
+    // 节点所在频次桶对应的频次：补做落后的衰减轮次，频次减到 1 后不再变化，
+    // 最多循环 log2(max_freq_) 次
+    size_t currentFreq(LRUNode<Key, Value>& node) {
+        while (node.epoch != decay_epoch_ && node.freq > 1) {
+            node.freq /= 2;
+            ++node.epoch;
+        }
+        node.epoch = decay_epoch_;
+        return node.freq;
+    }
+
+    // 频率衰减：只把频次桶整体减半合并，节点上的频次在下次访问时由 currentFreq 补算，
+    // 持锁时间只与桶数（不超过 max_freq_）有关，与缓存大小无关
     void freqDecay() {
         if (freq_map_.empty()) return;
     
         if (put_count_ < capacity_ ) return;
     
-        Freqmap new_freq_map;
-    
-        // 频率衰减：将每个频率减半
+        Freqmap new_freq_map(freq_map_.get_allocator());
         for (auto& [freq, nodes] : freq_map_) {
-            int new_freq = std::max(1, static_cast<int>(freq) / 2);
+            size_t new_freq = std::max<size_t>(1, freq / 2);
             new_freq_map[new_freq].splice(new_freq_map[new_freq].end(), nodes);
         }
-        
         freq_map_ = std::move(new_freq_map);
+        ++decay_epoch_;
+        put_count_ = 0;
 
-        for (auto& [key, it] : cache_) {
-            it->freq = std::max(1, static_cast<int>(it->freq) / 2);
+        // 更新 min_freq_，确保它指向有效的最小频率
+        size_t min_freq = freq_map_.begin()->first;
+        for (auto& entry : freq_map_) {
+            min_freq = std::min(min_freq, entry.first);
         }
-
-        put_count_ = 0;
-        
-         // 更新 min_freq_，确保它指向有效的最小频率
-    if (!freq_map_.empty()) {
-        min_freq_ = freq_map_.begin()->first;  // 获取 freq_map 中的最小频率
-    }
+        min_freq_ = static_cast<int>(min_freq);
     }
 };
 
@@ -280,17 +624,20 @@ private:
     size_t    capacity_;  // 总容量
     int       sliceNum_;  // 切片数量
     std::vector<std::unique_ptr<LFUMCache<Key, Value>>> lfuSliceCaches_;
+    std::mutex resizeMutex_;  // 串行化 resize/rebalance
 
 public:
 
-   HashLFUCache(size_t capacity, int sliceNum):
+   // upstream 非空时各分片直接使用它分配节点，须线程安全；为空时使用全局默认内存资源
+   HashLFUCache(size_t capacity, int sliceNum, std::pmr::memory_resource* upstream = nullptr):
    capacity_(capacity),
    sliceNum_(sliceNum > 0 ? sliceNum : std::thread::hardware_concurrency())
    {
         size_t sliceSize = std::ceil(capacity_ / static_cast<double>(sliceNum_));
         for (int i = 0; i < sliceNum_; ++i)
         {
-            lfuSliceCaches_.emplace_back(std::make_unique<LFUMCache<Key, Value> >(sliceSize)); 
+            std::pmr::memory_resource* resource = upstream != nullptr ? upstream : std::pmr::get_default_resource();
+            lfuSliceCaches_.emplace_back(std::make_unique<LFUMCache<Key, Value> >(sliceSize, MAX_FREQ, resource)); 
         }
    }
 
@@ -316,15 +663,103 @@ public:
        return value;
    }
 
-    // 清除缓存
-    void purge()
+   // 读-改-写操作转发给 key 所在分片，在分片锁内一次完成
+   Value compute(const Key& key, const typename LFUMCache<Key, Value>::ComputeFn& fn)
+   {
+       return lfuSliceCaches_[Hash(key) % sliceNum_]->compute(key, fn);
+   }
+
+   bool computeIfPresent(const Key& key, const typename LFUMCache<Key, Value>::UpdateFn& fn)
+   {
+       return lfuSliceCaches_[Hash(key) % sliceNum_]->computeIfPresent(key, fn);
+   }
+
+   bool putIfAbsent(const Key& key, const Value& value)
+   {
+       return lfuSliceCaches_[Hash(key) % sliceNum_]->putIfAbsent(key, value);
+   }
+
+   bool compareAndSet(const Key& key, const Value& expected, const Value& desired)
+   {
+       return lfuSliceCaches_[Hash(key) % sliceNum_]->compareAndSet(key, expected, desired);
+   }
+
+    // 在线调整总容量：逐个分片分批淘汰或扩容，不会长时间阻塞任何一个分片
+    void resize(size_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(resizeMutex_);
+        capacity_ = capacity;
+        size_t sliceSize = std::ceil(capacity / static_cast<double>(sliceNum_));
+        for (auto& slice : lfuSliceCaches_)
+        {
+            slice->setCapacity(sliceSize);
+        }
+    }
+
+    // 按各分片自上次调用以来的访问量重新分配容量，总容量不变，
+    // 每个分片至少保留平均容量的 minShare 倍
+    void rebalance(double minShare = 0.25)
+    {
+        std::lock_guard<std::mutex> lock(resizeMutex_);
+        std::vector<size_t> counts(sliceNum_);
+        size_t total = 0;
+        for (int i = 0; i < sliceNum_; ++i)
+        {
+            counts[i] = lfuSliceCaches_[i]->takeAccessCount();
+            total += counts[i];
+        }
+        if (total == 0) return;
+
+        size_t floor = std::max<size_t>(1, static_cast<size_t>(capacity_ / sliceNum_ * minShare));
+        size_t spare = capacity_ > floor * sliceNum_ ? capacity_ - floor * sliceNum_ : 0;
+        std::vector<size_t> targets(sliceNum_);
+        for (int i = 0; i < sliceNum_; ++i)
+        {
+            targets[i] = floor + static_cast<size_t>(spare * (counts[i] / static_cast<double>(total)));
+        }
+
+        // 先缩后扩，避免调整过程中总占用超过总容量
+        for (int i = 0; i < sliceNum_; ++i)
+        {
+            if (targets[i] < lfuSliceCaches_[i]->capacity()) lfuSliceCaches_[i]->setCapacity(targets[i]);
+        }
+        for (int i = 0; i < sliceNum_; ++i)
+        {
+            if (targets[i] > lfuSliceCaches_[i]->capacity()) lfuSliceCaches_[i]->setCapacity(targets[i]);
+        }
+    }
+
+    size_t capacity()
+    {
+        std::lock_guard<std::mutex> lock(resizeMutex_);
+        return capacity_;
+    }
+
+    size_t size()
+    {
+        size_t total = 0;
+        for (auto& slice : lfuSliceCaches_)
+        {
+            total += slice->size();
+        }
+        return total;
+    }
+
+    // 逐个分片清空，每个分片只在交换结构时短暂持锁
+    void clear()
     {
         for (auto& lfuSliceCache : lfuSliceCaches_)
         {
-            lfuSliceCache->purge();
+            lfuSliceCache->clear();
         }
     }
 
+    // 清除缓存，同 clear
+    void purge()
+    {
+        clear();
+    }
+
 };// class HashLFUCache
 
 
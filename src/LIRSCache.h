@@ -0,0 +1,351 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <unordered_map>
+#include "Cachepolicy.h"
+#include "IndexList.h"
+
+namespace CacheDemo
+{
+
+// LIRS：按“重用距离”而不是最近一次访问区分冷热。
+// 约 99% 的容量给 LIR（重用距离短）块，其余给常驻 HIR 块；栈 S 按访问顺序记录 LIR、HIR
+// 及不常驻的 HIR（只留 key），栈底始终是 LIR；队列 Q 按进入顺序记录常驻 HIR，淘汰总是取 Q 头。
+// HIR 块在 S 中被再次访问说明重用距离比栈底的 LIR 短，两者互换身份。
+// 一次性扫描和略大于缓存的循环只在 HIR 部分轮转，不会冲掉 LIR 部分。
+// 节点预先分配在 NodePool 中，S/Q 是用下标串起来的侵入式链表，命中不做任何分配
+template<typename Key, typename Value>
+class LIRSCache : public Cachepolicy<Key, Value>
+{
+private:
+    enum class Status : uint8_t { Lir, HirResident, HirNonResident };
+
+    struct Node
+    {
+        Key key{};
+        Value value{};
+        Status status = Status::HirResident;
+        bool inStack = false;
+        IndexLink s;  // 栈 S
+        IndexLink q;  // 队列 Q 或不常驻链表
+    };
+
+    using StackList = IndexList<Node, &Node::s>;
+    using QueueList = IndexList<Node, &Node::q>;
+
+public:
+    using ComputeFn = typename Cachepolicy<Key, Value>::ComputeFn;
+    using UpdateFn = typename Cachepolicy<Key, Value>::UpdateFn;
+    using Index = std::pmr::unordered_map<Key, uint32_t>;
+
+    // hirRatio: 常驻 HIR 占容量的比例，至少 1 个；不常驻 HIR 最多保留 capacity 个。
+    // resource 用于 key 索引
+    explicit LIRSCache(size_t capacity, double hirRatio = 0.01,
+                       std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : capacity_(capacity),
+          hirCapacity_(hirCapacityOf(capacity, hirRatio)),
+          lirCapacity_(capacity - hirCapacity_),
+          nonResidentLimit_(capacity),
+          pool_(capacity + nonResidentLimit_ + 1),
+          index_(resource)
+    {
+        index_.reserve(pool_.size());
+    }
+
+    ~LIRSCache() override = default;
+
+    void put(const Key& key, const Value& value) override
+    {
+        if (capacity_ == 0) return;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t i = findResident(key);
+        if (i != NIL_INDEX)
+        {
+            pool_[i].value = value;
+            touch(i);
+            return;
+        }
+        insert(key, value);
+    }
+
+    bool get(const Key& key, Value& value) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t i = findResident(key);
+        if (i == NIL_INDEX) return false;
+
+        value = pool_[i].value;
+        touch(i);
+        return true;
+    }
+
+    Value get(const Key& key)
+    {
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    // 以下读-改-写操作一次加锁完成，fn 在锁内执行，不能再访问本缓存
+    Value compute(const Key& key, const ComputeFn& fn) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t i = findResident(key);
+        if (i != NIL_INDEX)
+        {
+            pool_[i].value = fn(&pool_[i].value);
+            touch(i);
+            return pool_[i].value;
+        }
+        Value value = fn(nullptr);
+        if (capacity_ > 0) insert(key, value);
+        return value;
+    }
+
+    bool computeIfPresent(const Key& key, const UpdateFn& fn) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t i = findResident(key);
+        if (i == NIL_INDEX) return false;
+
+        pool_[i].value = fn(pool_[i].value);
+        touch(i);
+        return true;
+    }
+
+    bool putIfAbsent(const Key& key, const Value& value) override
+    {
+        if (capacity_ == 0) return false;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (findResident(key) != NIL_INDEX) return false;
+        insert(key, value);
+        return true;
+    }
+
+    bool compareAndSet(const Key& key, const Value& expected, const Value& desired) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t i = findResident(key);
+        if (i == NIL_INDEX || !(pool_[i].value == expected)) return false;
+
+        pool_[i].value = desired;
+        touch(i);
+        return true;
+    }
+
+    // 新的节点数组和索引在锁外准备好，持锁只做交换，旧数据在锁外释放
+    void clear() override
+    {
+        NodePool<Node> pool(pool_.size());
+        Index index(index_.get_allocator());
+        index.reserve(pool.size());
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pool.swap(pool_);
+            index.swap(index_);
+            stack_ = StackList();
+            hirQueue_ = QueueList();
+            nonResident_ = QueueList();
+            lirCount_ = 0;
+            residentCount_ = 0;
+        }
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    // 常驻（可命中）的条目数
+    size_t size()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return residentCount_;
+    }
+
+private:
+    static size_t hirCapacityOf(size_t capacity, double hirRatio)
+    {
+        if (capacity < 2) return 0;
+        size_t hir = static_cast<size_t>(capacity * hirRatio);
+        return std::min(std::max<size_t>(hir, 1), capacity - 1);
+    }
+
+    uint32_t findResident(const Key& key)
+    {
+        auto it = index_.find(key);
+        if (it == index_.end() || pool_[it->second].status == Status::HirNonResident) return NIL_INDEX;
+        return it->second;
+    }
+
+    // 命中常驻块（需持锁调用）
+    void touch(uint32_t i)
+    {
+        Node& node = pool_[i];
+        if (node.status == Status::Lir)
+        {
+            bool wasBottom = stack_.tail == i;
+            stack_.moveToFront(pool_.data(), i);
+            if (wasBottom) prune();
+            return;
+        }
+
+        if (node.inStack)
+        {
+            // 重用距离比栈底 LIR 短：升为 LIR，栈底 LIR 降为 HIR
+            stack_.moveToFront(pool_.data(), i);
+            hirQueue_.unlink(pool_.data(), i);
+            node.status = Status::Lir;
+            ++lirCount_;
+            demoteBottom();
+        }
+        else
+        {
+            stack_.pushFront(pool_.data(), i);
+            node.inStack = true;
+            hirQueue_.unlink(pool_.data(), i);
+            hirQueue_.pushBack(pool_.data(), i);
+        }
+    }
+
+    // 写入不常驻的 key（需持锁调用）
+    void insert(const Key& key, const Value& value)
+    {
+        // 先腾位置再查索引：淘汰可能顺带移除最旧的不常驻节点，其中可能就有 key
+        if (residentCount_ >= capacity_) evict();
+
+        auto it = index_.find(key);
+        if (it != index_.end())
+        {
+            // 不常驻但仍在 S 中：重用距离足够短，直接作为 LIR 载入
+            uint32_t i = it->second;
+            Node& node = pool_[i];
+            nonResident_.unlink(pool_.data(), i);
+            node.value = value;
+            node.status = Status::Lir;
+            stack_.moveToFront(pool_.data(), i);
+            ++lirCount_;
+            ++residentCount_;
+            demoteBottom();
+            return;
+        }
+
+        uint32_t i = pool_.acquire();
+        Node& node = pool_[i];
+        node.key = key;
+        node.value = value;
+        node.inStack = true;
+        stack_.pushFront(pool_.data(), i);
+        if (lirCount_ < lirCapacity_)
+        {
+            // 预热阶段：LIR 未满时新块直接作为 LIR
+            node.status = Status::Lir;
+            ++lirCount_;
+        }
+        else
+        {
+            node.status = Status::HirResident;
+            hirQueue_.pushBack(pool_.data(), i);
+        }
+        index_.emplace(key, i);
+        ++residentCount_;
+    }
+
+    // 淘汰 Q 头的常驻 HIR；仍在 S 中的保留为不常驻 HIR（需持锁调用）
+    void evict()
+    {
+        if (hirQueue_.empty())
+        {
+            // 容量为 1 时没有 HIR 部分，直接淘汰栈底 LIR
+            uint32_t bottom = stack_.tail;
+            stack_.unlink(pool_.data(), bottom);
+            --lirCount_;
+            --residentCount_;
+            release(bottom);
+            prune();
+            return;
+        }
+
+        uint32_t i = hirQueue_.head;
+        Node& node = pool_[i];
+        hirQueue_.unlink(pool_.data(), i);
+        --residentCount_;
+        if (!node.inStack)
+        {
+            release(i);
+            return;
+        }
+
+        node.status = Status::HirNonResident;
+        node.value = Value{};
+        nonResident_.pushBack(pool_.data(), i);
+        if (nonResident_.size > nonResidentLimit_)
+        {
+            // 最旧的不常驻节点不可能在栈底（栈底总是 LIR），移出 S 不需要剪枝
+            uint32_t oldest = nonResident_.head;
+            nonResident_.unlink(pool_.data(), oldest);
+            stack_.unlink(pool_.data(), oldest);
+            release(oldest);
+        }
+    }
+
+    // LIR 超额时把栈底 LIR 降为常驻 HIR（需持锁调用）
+    void demoteBottom()
+    {
+        if (lirCount_ <= lirCapacity_) return;
+
+        uint32_t bottom = stack_.tail;
+        Node& node = pool_[bottom];
+        stack_.unlink(pool_.data(), bottom);
+        node.inStack = false;
+        node.status = Status::HirResident;
+        hirQueue_.pushBack(pool_.data(), bottom);
+        --lirCount_;
+        prune();
+    }
+
+    // 栈剪枝：移除栈底的 HIR 直到栈底是 LIR，不常驻的随之彻底删除（需持锁调用）
+    void prune()
+    {
+        while (stack_.tail != NIL_INDEX && pool_[stack_.tail].status != Status::Lir)
+        {
+            uint32_t bottom = stack_.tail;
+            Node& node = pool_[bottom];
+            stack_.unlink(pool_.data(), bottom);
+            node.inStack = false;
+            if (node.status == Status::HirNonResident)
+            {
+                nonResident_.unlink(pool_.data(), bottom);
+                release(bottom);
+            }
+        }
+    }
+
+    // 节点从索引中删除并放回空闲链表，调用前需已从 S/Q 摘下
+    void release(uint32_t i)
+    {
+        Node& node = pool_[i];
+        index_.erase(node.key);
+        node.value = Value{};
+        node.inStack = false;
+        pool_.release(i);
+    }
+
+private:
+    size_t capacity_;
+    size_t hirCapacity_;
+    size_t lirCapacity_;
+    size_t nonResidentLimit_;
+    NodePool<Node> pool_;      // 常驻 + 不常驻上限 + 1 个，后续不再分配
+    Index index_;              // key -> 节点下标，包括不常驻 HIR
+    StackList stack_;          // 栈 S，head 为栈顶
+    QueueList hirQueue_;       // 队列 Q，head 最先淘汰
+    QueueList nonResident_;    // 不常驻 HIR，按变为不常驻的先后排列
+    size_t lirCount_ = 0;
+    size_t residentCount_ = 0;
+    std::mutex mutex_;
+};
+
+} // namespace CacheDemo
@@ -1,13 +1,20 @@
 #pragma once
 
+#include<algorithm>
+#include<atomic>
 #include<cmath>
 #include<list>
+#include<memory_resource>
 #include<vector>
 #include<memory>
 #include<thread>
 #include<unordered_map>
 #include<mutex>
+#include<utility>
+#include"BloomFilter.h"
 #include"Cachepolicy.h"
+#include"CacheExecutor.h"
+#include"RemovalListener.h"
 
 namespace CacheDemo
 {
@@ -18,72 +25,435 @@ class LRUCache : public Cachepolicy<Key, Value>
 
 public:
     using Nodetype = std::pair<Key,Value>; 
-    using Listtype = std::list<Nodetype>;
+    using Listtype = std::pmr::list<Nodetype>;
     using ListIterator = typename Listtype::iterator;
-    using Hashmap = std::unordered_map<Key, ListIterator>;
-
-    explicit  LRUCache(size_t cap):capacity_(cap) 
+    using Hashmap = std::pmr::unordered_map<Key, ListIterator>;
+    using ComputeFn = typename Cachepolicy<Key, Value>::ComputeFn;
+    using UpdateFn = typename Cachepolicy<Key, Value>::UpdateFn;
+
+    // resource 用于链表节点和哈希表（节点与桶数组），默认使用全局默认内存资源。
+    // clear 和后台执行器会在锁外释放节点，多线程使用时 resource 必须线程安全
+    // （如 synchronized_pool_resource），unsynchronized_pool_resource 只适合单线程
+    explicit  LRUCache(size_t cap, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : capacity_(cap), Cachelist_(resource), Cachemap_(resource), retired_(resource)
     {
         Cachemap_.reserve(cap); 
     }
 
-    ~LRUCache() override = default;
+    ~LRUCache() override
+    {
+        // 已投递的节点批次仍在用本缓存的内存资源，资源可能随缓存一起销毁，需等它们释放完
+        if(executor_) executor_->flush();
+    }
 
     void put(const Key& key, const Value& value) override
     {
-        if(capacity_ == 0) return;
+        putImpl(key, value, nullptr);
+    }
+
+    // 与put相同，但把因容量不足被淘汰的尾部节点通过evicted传出，发生淘汰时返回true
+    // 便于上层（如磁盘分层）在锁外处理被淘汰的数据
+    bool putAndEvict(const Key& key, const Value& value, Nodetype& evicted)
+    {
+        return putImpl(key, value, &evicted);
+    }
+
+    bool get(const Key& key, Value& value) override
+    {
+        // 过滤器确认不存在时不加锁直接返回
+        if(missFilter_ && !missFilter_->mayContain(key)){
+            return false;
+        }
 
         std::lock_guard<std::mutex> lock(LRUmutex_);
+        ++accessCount_;
 
         auto it = Cachemap_.find(key);
-        if(it != Cachemap_.end()){
-            Cachelist_.erase(it->second);
-            Cachemap_.erase(it);
+        if(it == Cachemap_.end()){
+            return false;
         }
+        
+        value = it->second->second;
+        Cachelist_.splice(Cachelist_.begin(), Cachelist_, it->second);
 
-        if(Cachelist_.size() >= capacity_){
-            auto tail = Cachelist_.back();
-            Cachemap_.erase(tail.first);
-            Cachelist_.pop_back();
+        return true;
+    }
+
+    // 只读取值，不调整访问顺序也不计入访问次数，供写回等内部维护读取
+    bool peek(const Key& key, Value& value)
+    {
+        std::lock_guard<std::mutex> lock(LRUmutex_);
+        auto it = Cachemap_.find(key);
+        if(it == Cachemap_.end()){
+            return false;
+        }
+        value = it->second->second;
+        return true;
+    }
+
+    // 在锁内以只读方式把值交给 fn，不调整顺序、不复制、不发布移除事件；fn 不能再访问本缓存
+    template<typename Fn>
+    bool peekWith(const Key& key, Fn&& fn)
+    {
+        std::lock_guard<std::mutex> lock(LRUmutex_);
+        auto it = Cachemap_.find(key);
+        if(it == Cachemap_.end()){
+            return false;
         }
+        fn(static_cast<const Value&>(it->second->second));
+        return true;
+    }
 
-        Cachelist_.push_front({key, value});
-        Cachemap_[key] = Cachelist_.begin();
+    // 批量查找：结果写入 values[i]、found[i]，返回命中数，效果与按顺序逐个 get 相同。
+    // 每 LOOKUP_GROUP 个 key 加一次锁并分两步处理：先依次查完索引，再统一取值、移到头部。
+    // 组内查找互不依赖，乱序执行可以让各自的缓存未命中同时在途，
+    // 而不是每个 key 查完索引、读完节点再开始下一个
+    size_t getMany(const Key* keys, size_t count, Value* values, bool* found)
+    {
+        return getManyImpl(keys, count, [](size_t n) { return n; }, values, found);
     }
 
-    bool get(const Key& key, Value& value) override
+    // 只处理下标列在 indices 中的 count 个 key，供分片缓存把同一分片的 key 交给一次调用
+    size_t getMany(const Key* keys, const size_t* indices, size_t count, Value* values, bool* found)
+    {
+        return getManyImpl(keys, count, [indices](size_t n) { return indices[n]; }, values, found);
+    }
+
+    // 以下读-改-写操作都只加一次锁、查一次映射表，fn 在锁内执行，不能再访问本缓存
+    Value compute(const Key& key, const ComputeFn& fn) override
+    {
+        Listtype garbage(Cachelist_.get_allocator());
+        Value value;
+        {
+            std::lock_guard<std::mutex> lock(LRUmutex_);
+            ++accessCount_;
+
+            auto it = Cachemap_.find(key);
+            if(it != Cachemap_.end()){
+                value = fn(&it->second->second);
+                assignLocked(it->second, value);
+            } else {
+                value = fn(nullptr);
+                if(capacity_ > 0){
+                    linkLocked(Cachemap_.try_emplace(key).first, value, nullptr);
+                    filterAdd(key);
+                }
+            }
+            collectRetired(garbage);
+        }
+        releaseRetired(garbage);
+        return value;
+    }
+
+    bool computeIfPresent(const Key& key, const UpdateFn& fn) override
     {
         std::lock_guard<std::mutex> lock(LRUmutex_);
+        ++accessCount_;
 
         auto it = Cachemap_.find(key);
         if(it == Cachemap_.end()){
             return false;
         }
-        
-        value = it->second->second;
-        Cachelist_.splice(Cachelist_.begin(), Cachelist_, it->second);
+        assignLocked(it->second, fn(it->second->second));
+        return true;
+    }
 
+    bool putIfAbsent(const Key& key, const Value& value) override
+    {
+        if(capacity_ == 0) return false;
+
+        Listtype garbage(Cachelist_.get_allocator());
+        {
+            std::lock_guard<std::mutex> lock(LRUmutex_);
+            ++accessCount_;
+            // 锁外的判断只是快速路径，setCapacity(0) 可能在两者之间完成，空链表上 evictTail 是未定义行为
+            if(capacity_ == 0) return false;
+
+            auto slot = Cachemap_.try_emplace(key);
+            if(!slot.second){
+                return false;
+            }
+            linkLocked(slot.first, value, nullptr);
+            filterAdd(key);
+            collectRetired(garbage);
+        }
+        releaseRetired(garbage);
         return true;
     }
 
-    void deletenode(const Key& key){
+    bool compareAndSet(const Key& key, const Value& expected, const Value& desired) override
+    {
         std::lock_guard<std::mutex> lock(LRUmutex_);
+        ++accessCount_;
 
         auto it = Cachemap_.find(key);
-        if(it == Cachemap_.end()){
-            return;
+        if(it == Cachemap_.end() || !(it->second->second == expected)){
+            return false;
         }
+        assignLocked(it->second, desired);
+        return true;
+    }
 
-        Cachelist_.erase(it->second);
-        Cachemap_.erase(it);
+    void deletenode(const Key& key){
+        Listtype garbage(Cachelist_.get_allocator());
+        {
+            std::lock_guard<std::mutex> lock(LRUmutex_);
+
+            auto it = Cachemap_.find(key);
+            if(it == Cachemap_.end()){
+                return;
+            }
 
+            filterRemove(it->first);
+            notifyRemoval(it->second, RemovalCause::Explicit);
+            retire(it->second);
+            Cachemap_.erase(it);
+            collectRetired(garbage);
+        }
+        releaseRetired(garbage);
+    }
+
+    // 清空缓存：新映射表在锁外预先分配好，持锁只做交换；
+    // 旧节点有执行器时交给后台线程析构，否则在调用线程锁外析构
+    void clear() override
+    {
+        Listtype list(Cachelist_.get_allocator());
+        Hashmap map(Cachemap_.get_allocator());
+        map.reserve(capacity_);
+        {
+            std::lock_guard<std::mutex> lock(LRUmutex_);
+            list.swap(Cachelist_);
+            list.splice(list.end(), retired_);
+            map.swap(Cachemap_);
+            // 过滤器需与映射表同时清空，否则锁外的 get 可能把新写入的 key 判为不存在
+            if(missFilter_) missFilter_->reset();
+        }
+        releaseLater(executor_.get(), std::move(list), std::move(map));
+    }
+
+    // 设置后台维护执行器，被淘汰节点的析构改由后台线程批量完成
+    // 需在缓存投入使用前设置
+    void setExecutor(std::shared_ptr<CacheExecutor> executor)
+    {
+        std::lock_guard<std::mutex> lock(LRUmutex_);
+        executor_ = std::move(executor);
+    }
+
+    // 启用未命中过滤器：不存在的 key 在 get 中无需加锁即可返回。
+    // expected 为过滤器按多少个 key 分配，0 表示按当前容量；需在缓存投入使用前设置
+    void enableMissFilter(size_t expected = 0)
+    {
+        std::lock_guard<std::mutex> lock(LRUmutex_);
+        missFilter_ = std::make_unique<CountingBloomFilter<Key>>(expected > 0 ? expected : capacity_.load());
+        for(auto& entry : Cachemap_){
+            missFilter_->add(entry.first);
+        }
+    }
+
+    // 在线调整容量：扩容立即生效；缩容时分批淘汰，每批最多 step 个节点，批与批之间释放锁
+    void setCapacity(size_t cap, size_t step = RESIZE_STEP)
+    {
+        capacity_ = cap;
+        if(step == 0) step = 1;
+
+        bool done = false;
+        while(!done){
+            Listtype garbage(Cachelist_.get_allocator());
+            {
+                std::lock_guard<std::mutex> lock(LRUmutex_);
+                for(size_t n = 0; n < step && Cachelist_.size() > capacity_; ++n){
+                    evictTail();
+                }
+                done = Cachelist_.size() <= capacity_;
+                collectRetired(garbage);
+            }
+            releaseRetired(garbage);
+        }
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    size_t size()
+    {
+        std::lock_guard<std::mutex> lock(LRUmutex_);
+        return Cachelist_.size();
+    }
+
+    // 取出并清零自上次调用以来的访问次数，供分片容量再平衡使用
+    size_t takeAccessCount()
+    {
+        std::lock_guard<std::mutex> lock(LRUmutex_);
+        size_t count = accessCount_;
+        accessCount_ = 0;
+        return count;
+    }
+
+    // 设置移除监听：淘汰/覆盖/删除事件在锁内无锁入队，由分发器线程批量回调
+    // 通过 putAndEvict 传出的淘汰节点由调用方处理，不再通知
+    void setRemovalListener(std::shared_ptr<RemovalDispatcher<Key, Value>> dispatcher)
+    {
+        std::lock_guard<std::mutex> lock(LRUmutex_);
+        removalDispatcher_ = std::move(dispatcher);
     }
 
 private:
+    static constexpr size_t LOOKUP_GROUP = 16;
+
+    // indexOf(n) 给出第 n 个待查 key 在 keys/values/found 中的下标
+    template<typename IndexOf>
+    size_t getManyImpl(const Key* keys, size_t count, IndexOf indexOf, Value* values, bool* found)
+    {
+        ListIterator nodes[LOOKUP_GROUP];
+        size_t hits = 0;
+        for(size_t begin = 0; begin < count; begin += LOOKUP_GROUP){
+            size_t n = std::min(LOOKUP_GROUP, count - begin);
+            std::lock_guard<std::mutex> lock(LRUmutex_);
+            accessCount_ += n;
+
+            for(size_t j = 0; j < n; ++j){
+                size_t i = indexOf(begin + j);
+                found[i] = false;
+                nodes[j] = Cachelist_.end();
+                if(missFilter_ && !missFilter_->mayContain(keys[i])) continue;
+
+                auto it = Cachemap_.find(keys[i]);
+                if(it == Cachemap_.end()) continue;
+                nodes[j] = it->second;
+            }
+            for(size_t j = 0; j < n; ++j){
+                if(nodes[j] == Cachelist_.end()) continue;
+                size_t i = indexOf(begin + j);
+                values[i] = nodes[j]->second;
+                found[i] = true;
+                ++hits;
+                Cachelist_.splice(Cachelist_.begin(), Cachelist_, nodes[j]);
+            }
+        }
+        return hits;
+    }
+
+    bool putImpl(const Key& key, const Value& value, Nodetype* evicted)
+    {
+        if(capacity_ == 0) return false;
+
+        Listtype garbage(Cachelist_.get_allocator());
+        bool hasEvicted = false;
+        {
+            std::lock_guard<std::mutex> lock(LRUmutex_);
+            ++accessCount_;
+            // 同 putIfAbsent，锁内再确认一次容量
+            if(capacity_ == 0) return false;
+
+            // 一次探测：已存在则复用映射表中的位置，旧节点照常回收
+            auto slot = Cachemap_.try_emplace(key);
+            if(!slot.second){
+                notifyRemoval(slot.first->second, RemovalCause::Replaced);
+                retire(slot.first->second);
+            }
+            hasEvicted = linkLocked(slot.first, value, evicted);
+            if(slot.second) filterAdd(key);
+            collectRetired(garbage);
+        }
+        releaseRetired(garbage);
+        return hasEvicted;
+    }
+
+    // 映射表中已为 key 占好位置，新建节点挂到链表头，超出容量时先淘汰尾部（需持锁调用）
+    bool linkLocked(typename Hashmap::iterator slot, const Value& value, Nodetype* evicted)
+    {
+        bool hasEvicted = false;
+        if(Cachelist_.size() >= capacity_){
+            if(evicted != nullptr){
+                auto tail = std::prev(Cachelist_.end());
+                Cachemap_.erase(tail->first);
+                filterRemove(tail->first);
+                *evicted = std::move(*tail);
+                Cachelist_.erase(tail);
+                hasEvicted = true;
+            } else {
+                evictTail();
+            }
+        }
 
-    size_t capacity_;
+        Cachelist_.push_front({slot->first, value});
+        slot->second = Cachelist_.begin();
+        return hasEvicted;
+    }
+
+    // 原地更新已有节点并移到链表头，旧值作为覆盖事件发布（需持锁调用）
+    void assignLocked(ListIterator node, const Value& value)
+    {
+        if(removalDispatcher_){
+            removalDispatcher_->publish(node->first, std::move(node->second), RemovalCause::Replaced);
+        }
+        node->second = value;
+        Cachelist_.splice(Cachelist_.begin(), Cachelist_, node);
+    }
+
+    // 淘汰链表尾部节点（需持锁调用）
+    void evictTail()
+    {
+        auto tail = std::prev(Cachelist_.end());
+        Cachemap_.erase(tail->first);
+        filterRemove(tail->first);
+        notifyRemoval(tail, RemovalCause::Capacity);
+        retire(tail);
+    }
+
+    // 过滤器与映射表同步增删（需持锁调用）
+    void filterAdd(const Key& key)
+    {
+        if(missFilter_) missFilter_->add(key);
+    }
+
+    void filterRemove(const Key& key)
+    {
+        if(missFilter_) missFilter_->remove(key);
+    }
+
+    // 节点即将被摘除，把 key/value 移交给分发器（需持锁调用，且映射表已不再依赖该节点的 key）
+    void notifyRemoval(ListIterator it, RemovalCause cause)
+    {
+        if(removalDispatcher_){
+            removalDispatcher_->publish(std::move(it->first), std::move(it->second), cause);
+        }
+    }
+
+    // 从链表摘下节点：有执行器时只挂到待回收链表，不在锁内析构
+    void retire(ListIterator it)
+    {
+        if(executor_){
+            retired_.splice(retired_.end(), Cachelist_, it);
+        } else {
+            Cachelist_.erase(it);
+        }
+    }
+
+    // 攒够一批后整体取走（需持锁调用）
+    void collectRetired(Listtype& garbage)
+    {
+        if(retired_.size() >= RETIRE_BATCH){
+            garbage.swap(retired_);
+        }
+    }
+
+    // 锁外把整批节点交给后台线程析构
+    void releaseRetired(Listtype& garbage)
+    {
+        if(garbage.empty()) return;
+        executor_->post([nodes = std::move(garbage)]() mutable { nodes.clear(); });
+    }
+
+private:
+
+    std::atomic<size_t> capacity_;
+    size_t accessCount_ = 0;  // 访问计数，持锁更新
     Listtype Cachelist_;
     Hashmap Cachemap_;
+    Listtype retired_;  // 等待后台析构的节点
+    std::shared_ptr<CacheExecutor> executor_;
+    std::shared_ptr<RemovalDispatcher<Key, Value>> removalDispatcher_;
+    std::unique_ptr<CountingBloomFilter<Key>> missFilter_;  // 可选的未命中过滤器，get 无锁读取
     std::mutex LRUmutex_;
 };
 
@@ -91,34 +461,56 @@ private:
 template<typename Key, typename Value>
 class LRUKCache : public LRUCache<Key, Value> {
 public:
-    LRUKCache(size_t cap, size_t historycap, int k)
-        : LRUCache<Key, Value>(cap),
-          historylist_(std::make_unique<LRUCache<Key, size_t>>(historycap)),
+    LRUKCache(size_t cap, size_t historycap, int k,
+              std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : LRUCache<Key, Value>(cap, resource),
+          historylist_(std::make_unique<LRUCache<Key, size_t>>(historycap, resource)),
           k_(k) {}
 
+    using ComputeFn = typename LRUCache<Key, Value>::ComputeFn;
+
     void put(const Key& key, const Value& value) override
     {
-        Value tempvalue;
-        if (LRUCache<Key, Value>::get(key, tempvalue)) {
-            LRUCache<Key, Value>::put(key, value);
+        // 已在缓存中的 key 一次加锁原地更新
+        if (LRUCache<Key, Value>::computeIfPresent(key, [&value](const Value&) { return value; })) {
             return;
         }
 
-        size_t historycount = 0;
         std::lock_guard<std::mutex> lock(historymutex_);
-
-        if (!historylist_->get(key, historycount)) {
-            historycount = 1;
-        } else {
-            historycount++;
+        // 新 key 只在 historymutex_ 内插入，加锁后再确认一次，避免把并发插入的 key 当作新 key 重走准入
+        if (LRUCache<Key, Value>::computeIfPresent(key, [&value](const Value&) { return value; })) {
+            return;
         }
+        admitLocked(key, value);
+    }
 
-        historylist_->put(key, historycount);
+    void clear() override
+    {
+        LRUCache<Key, Value>::clear();
+        historylist_->clear();
+    }
 
-        if (historycount >= k_) {
-            historylist_->deletenode(key);
-            LRUCache<Key, Value>::put(key, value);
+    // 新 key 只会在 historymutex_ 内插入，持有它时“不存在”不会被其他写入改变，
+    // 因此以下两个操作持 historymutex_ 完成即为原子的；不存在的 key 仍需经过访问历史准入
+    Value compute(const Key& key, const ComputeFn& fn) override
+    {
+        std::lock_guard<std::mutex> lock(historymutex_);
+        Value value;
+        if (LRUCache<Key, Value>::computeIfPresent(key, [&](const Value& old) { return value = fn(&old); })) {
+            return value;
         }
+        value = fn(nullptr);
+        admitLocked(key, value);
+        return value;
+    }
+
+    // 返回是否真的写入：key 已存在或未通过访问历史准入时都返回 false
+    bool putIfAbsent(const Key& key, const Value& value) override
+    {
+        std::lock_guard<std::mutex> lock(historymutex_);
+        Value existing;
+        if (LRUCache<Key, Value>::peek(key, existing)) return false;
+        return admitLocked(key, value);
     }
 
     bool get(const Key& key, Value& value) override
@@ -137,8 +529,36 @@ public:
     return LRUCache<Key, Value>::get(key, value);
     }
 
+    // 每个 key 都要更新访问历史，批量查找逐个转给 get
+    size_t getMany(const Key* keys, size_t count, Value* values, bool* found)
+    {
+        size_t hits = 0;
+        for (size_t i = 0; i < count; ++i) {
+            found[i] = get(keys[i], values[i]);
+            if (found[i]) ++hits;
+        }
+        return hits;
+    }
+
 
 private:
+    // 新 key 的访问次数加一，达到 k 次才写入缓存，返回是否写入（需持 historymutex_）
+    bool admitLocked(const Key& key, const Value& value)
+    {
+        size_t historycount = 0;
+        if (!historylist_->get(key, historycount)) {
+            historycount = 1;
+        } else {
+            historycount++;
+        }
+        historylist_->put(key, historycount);
+
+        if (historycount < k_ || this->capacity() == 0) return false;
+        historylist_->deletenode(key);
+        LRUCache<Key, Value>::put(key, value);
+        return true;
+    }
+
     int k_;  
     std::unique_ptr<LRUCache<Key, size_t>> historylist_;
     std::mutex historymutex_;
@@ -163,7 +583,8 @@ private:
 
 public:
 
-   HashLRUCache(size_t capacity, int slicenum):
+   // upstream 非空时各分片直接使用它分配节点，须线程安全；为空时使用全局默认内存资源
+   HashLRUCache(size_t capacity, int slicenum, std::pmr::memory_resource* upstream = nullptr):
    capacity_(capacity),
    sliceNum_(slicenum > 0 ? slicenum : std::thread::hardware_concurrency())
    {
@@ -171,7 +592,8 @@ public:
     size_t sliceSize = std::ceil(capacity / static_cast<double>(sliceNum_)); 
         for (int i = 0; i < sliceNum_; ++i)
         {
-            lruSliceCaches_.emplace_back(std::make_unique<LRUCache<Key, Value> >(sliceSize)); 
+            std::pmr::memory_resource* resource = upstream != nullptr ? upstream : std::pmr::get_default_resource();
+            lruSliceCaches_.emplace_back(std::make_unique<LRUCache<Key, Value> >(sliceSize, resource)); 
         }
    }
 
@@ -182,6 +604,13 @@ public:
        return lruSliceCaches_[sliceIndex]->put(key, value);
    }
 
+   // 与 LRUCache::putAndEvict 相同，被淘汰的节点通过 evicted 传出
+   bool putAndEvict(const Key& key, const Value& value, typename LRUCache<Key, Value>::Nodetype& evicted)
+   {
+       size_t sliceIndex = Hash(key) % sliceNum_;
+       return lruSliceCaches_[sliceIndex]->putAndEvict(key, value, evicted);
+   }
+
    bool get(const Key& key, Value& value)
    {
        // 获取key的hash值，并计算出对应的分片索引
@@ -196,6 +625,166 @@ public:
        return value;
    }
 
+   bool peek(const Key& key, Value& value)
+   {
+       return lruSliceCaches_[Hash(key) % sliceNum_]->peek(key, value);
+   }
+
+   template<typename Fn>
+   bool peekWith(const Key& key, Fn&& fn)
+   {
+       return lruSliceCaches_[Hash(key) % sliceNum_]->peekWith(key, std::forward<Fn>(fn));
+   }
+
+   int sliceNum() const { return sliceNum_; }
+
+   // key 所在分片的下标，同一分片内的淘汰只会挤出同一分片的 key
+   size_t sliceOf(const Key& key) { return Hash(key) % sliceNum_; }
+
+   // 批量查找：按分片归类后每个分片调用一次 LRUCache::getMany，同一分片内保持原顺序。
+   // 归类用计数排序，下标放在一块按线程复用的缓冲区里，各分片只记起止偏移，稳定后不再分配内存
+   size_t getMany(const Key* keys, size_t count, Value* values, bool* found)
+   {
+       thread_local std::vector<size_t> sliceOf;
+       thread_local std::vector<size_t> order;
+       thread_local std::vector<size_t> offsets;
+       sliceOf.resize(count);
+       order.resize(count);
+       offsets.assign(sliceNum_ + 1, 0);
+
+       for (size_t i = 0; i < count; ++i)
+       {
+           sliceOf[i] = Hash(keys[i]) % sliceNum_;
+           ++offsets[sliceOf[i] + 1];
+       }
+       for (int i = 0; i < sliceNum_; ++i)
+       {
+           offsets[i + 1] += offsets[i];
+       }
+       // 按原顺序逐个放入所属分片的区间，放完后 offsets[i] 前移到下一个分片的起点
+       for (size_t i = 0; i < count; ++i)
+       {
+           order[offsets[sliceOf[i]]++] = i;
+       }
+
+       size_t hits = 0;
+       size_t begin = 0;
+       for (int i = 0; i < sliceNum_; ++i)
+       {
+           size_t end = offsets[i];
+           if (end > begin)
+           {
+               hits += lruSliceCaches_[i]->getMany(keys, order.data() + begin, end - begin, values, found);
+           }
+           begin = end;
+       }
+       return hits;
+   }
+
+   // 读-改-写操作转发给 key 所在分片，在分片锁内一次完成
+   Value compute(const Key& key, const typename LRUCache<Key, Value>::ComputeFn& fn)
+   {
+       return lruSliceCaches_[Hash(key) % sliceNum_]->compute(key, fn);
+   }
+
+   bool computeIfPresent(const Key& key, const typename LRUCache<Key, Value>::UpdateFn& fn)
+   {
+       return lruSliceCaches_[Hash(key) % sliceNum_]->computeIfPresent(key, fn);
+   }
+
+   bool putIfAbsent(const Key& key, const Value& value)
+   {
+       return lruSliceCaches_[Hash(key) % sliceNum_]->putIfAbsent(key, value);
+   }
+
+   bool compareAndSet(const Key& key, const Value& expected, const Value& desired)
+   {
+       return lruSliceCaches_[Hash(key) % sliceNum_]->compareAndSet(key, expected, desired);
+   }
+
+   // 在线调整总容量：逐个分片分批淘汰或扩容，不会长时间阻塞任何一个分片
+   void resize(size_t capacity)
+   {
+       std::lock_guard<std::mutex> lock(resizeMutex_);
+       capacity_ = capacity;
+       size_t sliceSize = std::ceil(capacity / static_cast<double>(sliceNum_));
+       for (auto& slice : lruSliceCaches_)
+       {
+           slice->setCapacity(sliceSize);
+       }
+   }
+
+   // 按各分片自上次调用以来的访问量重新分配容量，总容量不变，
+   // 每个分片至少保留平均容量的 minShare 倍
+   void rebalance(double minShare = 0.25)
+   {
+       std::lock_guard<std::mutex> lock(resizeMutex_);
+       std::vector<size_t> counts(sliceNum_);
+       size_t total = 0;
+       for (int i = 0; i < sliceNum_; ++i)
+       {
+           counts[i] = lruSliceCaches_[i]->takeAccessCount();
+           total += counts[i];
+       }
+       if (total == 0) return;
+
+       size_t floor = std::max<size_t>(1, static_cast<size_t>(capacity_ / sliceNum_ * minShare));
+       size_t spare = capacity_ > floor * sliceNum_ ? capacity_ - floor * sliceNum_ : 0;
+       std::vector<size_t> targets(sliceNum_);
+       for (int i = 0; i < sliceNum_; ++i)
+       {
+           targets[i] = floor + static_cast<size_t>(spare * (counts[i] / static_cast<double>(total)));
+       }
+
+       // 先缩后扩，避免调整过程中总占用超过总容量
+       for (int i = 0; i < sliceNum_; ++i)
+       {
+           if (targets[i] < lruSliceCaches_[i]->capacity()) lruSliceCaches_[i]->setCapacity(targets[i]);
+       }
+       for (int i = 0; i < sliceNum_; ++i)
+       {
+           if (targets[i] > lruSliceCaches_[i]->capacity()) lruSliceCaches_[i]->setCapacity(targets[i]);
+       }
+   }
+
+   size_t capacity()
+   {
+       std::lock_guard<std::mutex> lock(resizeMutex_);
+       return capacity_;
+   }
+
+   size_t size()
+   {
+       size_t total = 0;
+       for (auto& slice : lruSliceCaches_)
+       {
+           total += slice->size();
+       }
+       return total;
+   }
+
+   // 逐个分片清空，每个分片只在交换结构时短暂持锁
+   void clear()
+   {
+       for (auto& slice : lruSliceCaches_)
+       {
+           slice->clear();
+       }
+   }
+
+   // 为每个分片启用未命中过滤器，按分片当前容量分配；
+   // rebalance 后分片容量变大只会提高假阳性率，不会漏报。需在投入使用前调用
+   void enableMissFilter()
+   {
+       for (auto& slice : lruSliceCaches_)
+       {
+           slice->enableMissFilter();
+       }
+   }
+
+private:
+   std::mutex resizeMutex_;  // 串行化 resize/rebalance
+
 };
 
 } // namespace CacheDemo
\ No newline at end of file
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace CacheDemo
+{
+
+// 无依赖的 LZ77 编解码器，格式参照 LZ4：
+// 开头是原始长度（varint），之后是若干序列，每个序列为
+// token（高 4 位字面量长度，低 4 位匹配长度 - 4，取 15 时后面跟 255 累加的扩展长度）、
+// 字面量、2 字节小端偏移、匹配长度扩展；最后一个序列只有字面量。
+// 追求速度而非压缩率，适合 JSON、序列化数据这类重复较多的值。
+// 可替换的编解码器需要提供同样签名的 compress / decompress 静态函数
+class LZCodec
+{
+public:
+    // 把 size 字节的 data 压缩到 out（覆盖原内容）
+    static void compress(const char* data, size_t size, std::string& out)
+    {
+        out.clear();
+        out.reserve(size / 2 + 16);
+        putVarint(out, size);
+
+        const uint8_t* src = reinterpret_cast<const uint8_t*>(data);
+        size_t anchor = 0;
+        if (size > MIN_MATCH + LAST_LITERALS)
+        {
+            // 记录每个 4 字节序列最近出现的位置 + 1，0 表示没有
+            std::array<uint32_t, HASH_SIZE> table{};
+            size_t limit = size - LAST_LITERALS;
+            size_t p = 0;
+            while (p + MIN_MATCH <= limit)
+            {
+                uint32_t seq = load32(src + p);
+                uint32_t& slot = table[hash(seq)];
+                size_t candidate = slot;
+                slot = static_cast<uint32_t>(p + 1);
+                if (candidate == 0 || p - (candidate - 1) > MAX_OFFSET || load32(src + candidate - 1) != seq)
+                {
+                    // 连续找不到匹配时逐渐加大步长，不可压缩的数据很快扫过去
+                    p += 1 + ((p - anchor) >> 6);
+                    continue;
+                }
+
+                size_t match = candidate - 1;
+                size_t length = MIN_MATCH;
+                while (p + length < limit && src[match + length] == src[p + length]) ++length;
+                putSequence(out, src + anchor, p - anchor, p - match, length);
+                p += length;
+                anchor = p;
+            }
+        }
+        putLastLiterals(out, src + anchor, size - anchor);
+    }
+
+    // 解压到 out（复用其已有的容量），数据损坏时返回 false
+    static bool decompress(const char* data, size_t size, std::string& out)
+    {
+        const uint8_t* in = reinterpret_cast<const uint8_t*>(data);
+        size_t ip = 0;
+        uint64_t rawSize = 0;
+        if (!getVarint(in, size, ip, rawSize)) return false;
+        // 每个输入字节最多展开为 255 + MIN_MATCH 个输出字节，超出说明长度字段已损坏
+        if (rawSize / (255 + MIN_MATCH) > size - ip) return false;
+        out.resize(rawSize);
+        if (rawSize == 0) return true;
+
+        uint8_t* dst = reinterpret_cast<uint8_t*>(&out[0]);
+        size_t op = 0;
+        while (ip < size)
+        {
+            uint8_t token = in[ip++];
+            size_t literals = token >> 4;
+            if (literals == 15 && !getLength(in, size, ip, literals)) return false;
+            if (literals > size - ip || literals > rawSize - op) return false;
+            std::memcpy(dst + op, in + ip, literals);
+            ip += literals;
+            op += literals;
+            if (ip == size) break;
+
+            if (size - ip < 2) return false;
+            size_t offset = in[ip] | (static_cast<size_t>(in[ip + 1]) << 8);
+            ip += 2;
+            size_t length = token & 15;
+            if (length == 15 && !getLength(in, size, ip, length)) return false;
+            length += MIN_MATCH;
+            if (offset == 0 || offset > op || length > rawSize - op) return false;
+
+            // 偏移小于长度时源和目标重叠，需要逐字节复制
+            if (offset >= length)
+            {
+                std::memcpy(dst + op, dst + op - offset, length);
+                op += length;
+            }
+            else
+            {
+                for (size_t n = 0; n < length; ++n, ++op) dst[op] = dst[op - offset];
+            }
+        }
+        return op == rawSize;
+    }
+
+private:
+    static constexpr size_t MIN_MATCH = 4;
+    static constexpr size_t LAST_LITERALS = 5;
+    static constexpr size_t MAX_OFFSET = 65535;
+    static constexpr int HASH_BITS = 12;
+    static constexpr size_t HASH_SIZE = size_t(1) << HASH_BITS;
+
+    static uint32_t load32(const uint8_t* p)
+    {
+        uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    static uint32_t hash(uint32_t seq)
+    {
+        return (seq * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    static void putVarint(std::string& out, uint64_t v)
+    {
+        while (v >= 0x80)
+        {
+            out.push_back(static_cast<char>(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<char>(v));
+    }
+
+    static bool getVarint(const uint8_t* in, size_t size, size_t& ip, uint64_t& v)
+    {
+        v = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            if (ip >= size) return false;
+            uint8_t b = in[ip++];
+            v |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+
+    static void putLength(std::string& out, size_t v)
+    {
+        for (; v >= 255; v -= 255) out.push_back(static_cast<char>(255));
+        out.push_back(static_cast<char>(v));
+    }
+
+    static bool getLength(const uint8_t* in, size_t size, size_t& ip, size_t& v)
+    {
+        uint8_t b;
+        do
+        {
+            if (ip >= size) return false;
+            b = in[ip++];
+            v += b;
+        } while (b == 255);
+        return true;
+    }
+
+    static void putSequence(std::string& out, const uint8_t* literals, size_t literalLength,
+                            size_t offset, size_t matchLength)
+    {
+        size_t extra = matchLength - MIN_MATCH;
+        out.push_back(static_cast<char>((std::min<size_t>(literalLength, 15) << 4) | std::min<size_t>(extra, 15)));
+        if (literalLength >= 15) putLength(out, literalLength - 15);
+        out.append(reinterpret_cast<const char*>(literals), literalLength);
+        out.push_back(static_cast<char>(offset & 0xFF));
+        out.push_back(static_cast<char>(offset >> 8));
+        if (extra >= 15) putLength(out, extra - 15);
+    }
+
+    static void putLastLiterals(std::string& out, const uint8_t* literals, size_t literalLength)
+    {
+        out.push_back(static_cast<char>(std::min<size_t>(literalLength, 15) << 4));
+        if (literalLength >= 15) putLength(out, literalLength - 15);
+        out.append(reinterpret_cast<const char*>(literals), literalLength);
+    }
+};
+
+} // namespace CacheDemo
@@ -0,0 +1,307 @@
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+#include "LRUCache.h"
+
+namespace CacheDemo
+{
+
+// NUMA 拓扑查询，信息取自 /sys/devices/system/node，读不到时按单节点处理
+class NumaTopology
+{
+public:
+    // 在线节点数（至少为 1）
+    static int nodeCount()
+    {
+        std::vector<int> nodes = parseList(readFile("/sys/devices/system/node/online"));
+        int count = 0;
+        for (int node : nodes)
+        {
+            if (node + 1 > count) count = node + 1;
+        }
+        return count > 0 ? count : 1;
+    }
+
+    // 节点上的 CPU 列表，读不到时返回空
+    static std::vector<int> cpusOf(int node)
+    {
+        return parseList(readFile("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+    }
+
+    // 当前线程正在运行的节点
+    static int currentNode()
+    {
+        unsigned cpu = 0;
+        unsigned node = 0;
+        if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) return 0;
+        return static_cast<int>(node);
+    }
+
+    // 把当前线程绑定到节点上的 CPU，失败（无权限、节点不存在）时返回 false 且不改变亲和性
+    static bool bindCurrentThread(int node)
+    {
+        std::vector<int> cpus = cpusOf(node);
+        if (cpus.empty()) return false;
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cpus)
+        {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+        }
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+
+private:
+    static std::string readFile(const std::string& path)
+    {
+        std::ifstream in(path);
+        std::string line;
+        std::getline(in, line);
+        return line;
+    }
+
+    // 解析 "0-3,8,10-11" 形式的列表
+    static std::vector<int> parseList(const std::string& text)
+    {
+        std::vector<int> result;
+        size_t pos = 0;
+        while (pos < text.size())
+        {
+            size_t end = text.find(',', pos);
+            if (end == std::string::npos) end = text.size();
+            std::string item = text.substr(pos, end - pos);
+            pos = end + 1;
+            if (item.empty()) continue;
+
+            size_t dash = item.find('-');
+            try
+            {
+                int first = std::stoi(item.substr(0, dash));
+                int last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+                for (int i = first; i <= last; ++i) result.push_back(i);
+            }
+            catch (...)
+            {
+                return {};
+            }
+        }
+        return result;
+    }
+};
+
+// 从指定 NUMA 节点分配内存的上游资源：mmap 后用 mbind 设置首选节点，
+// 内核不支持或调用失败时退化为普通 mmap（由首次访问决定落点）。
+// 每次分配都是一次 mmap，应作为池化资源的上游使用
+class NumaNodeResource : public std::pmr::memory_resource
+{
+public:
+    explicit NumaNodeResource(int node) : node_(node), bound_(false) {}
+
+    int node() const { return node_; }
+
+    // 最近一次 mbind 是否成功，用于判断是否真的做到了节点本地分配；还没有分配过或没做 mbind 时为 false
+    bool bound() const { return bound_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr int MPOL_PREFERRED_MODE = 1;
+
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        if (alignment > pageSize()) throw std::bad_alloc();
+        size_t length = roundUp(bytes);
+        void* addr = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (addr == MAP_FAILED) throw std::bad_alloc();
+
+        if (node_ >= 0 && node_ < 64)
+        {
+            unsigned long mask = 1UL << node_;
+            // 首选而非强制绑定，节点内存不足时允许回落到其他节点
+            bound_.store(syscall(SYS_mbind, addr, length, MPOL_PREFERRED_MODE, &mask, 64, 0) == 0,
+                         std::memory_order_relaxed);
+        }
+        return addr;
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t) override
+    {
+        ::munmap(p, roundUp(bytes));
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    static size_t pageSize()
+    {
+        static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    static size_t roundUp(size_t bytes)
+    {
+        size_t page = pageSize();
+        return (bytes + page - 1) / page * page;
+    }
+
+private:
+    int node_;
+    std::atomic<bool> bound_;
+};
+
+// NUMA 感知的分片 LRU：分片按节点划分，每个分片的链表节点和哈希桶
+// 都从所属节点的内存池分配。nodeOf 给出 key 所在节点，
+// 调用方可以把请求交给绑定在该节点上的线程处理，让访问始终落在本地内存
+template<typename Key, typename Value>
+class NumaHashLRUCache
+{
+public:
+    // slicesPerNode <= 0 时取每个节点的 CPU 数
+    NumaHashLRUCache(size_t capacity, int slicesPerNode = 0)
+        : capacity_(capacity),
+          nodeCount_(NumaTopology::nodeCount())
+    {
+        if (slicesPerNode <= 0)
+        {
+            slicesPerNode = static_cast<int>(NumaTopology::cpusOf(0).size());
+            if (slicesPerNode <= 0) slicesPerNode = 1;
+        }
+        slicesPerNode_ = slicesPerNode;
+        sliceNum_ = nodeCount_ * slicesPerNode_;
+
+        size_t sliceSize = std::ceil(capacity / static_cast<double>(sliceNum_));
+        for (int node = 0; node < nodeCount_; ++node)
+        {
+            nodeResources_.emplace_back(std::make_unique<NumaNodeResource>(node));
+        }
+        for (int i = 0; i < sliceNum_; ++i)
+        {
+            // 分片锁内串行访问，但节点可能在执行器线程上释放，池需要线程安全
+            pools_.emplace_back(std::make_unique<std::pmr::synchronized_pool_resource>(
+                nodeResources_[i / slicesPerNode_].get()));
+            slices_.emplace_back(std::make_unique<LRUCache<Key, Value>>(sliceSize, pools_.back().get()));
+        }
+    }
+
+    NumaHashLRUCache(const NumaHashLRUCache&) = delete;
+    NumaHashLRUCache& operator=(const NumaHashLRUCache&) = delete;
+
+    void put(const Key& key, const Value& value)
+    {
+        slices_[sliceIndex(key)]->put(key, value);
+    }
+
+    bool putAndEvict(const Key& key, const Value& value, typename LRUCache<Key, Value>::Nodetype& evicted)
+    {
+        return slices_[sliceIndex(key)]->putAndEvict(key, value, evicted);
+    }
+
+    bool get(const Key& key, Value& value)
+    {
+        return slices_[sliceIndex(key)]->get(key, value);
+    }
+
+    Value get(const Key& key)
+    {
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    // 读-改-写操作转发给 key 所在分片，在分片锁内一次完成
+    Value compute(const Key& key, const typename LRUCache<Key, Value>::ComputeFn& fn)
+    {
+        return slices_[sliceIndex(key)]->compute(key, fn);
+    }
+
+    bool computeIfPresent(const Key& key, const typename LRUCache<Key, Value>::UpdateFn& fn)
+    {
+        return slices_[sliceIndex(key)]->computeIfPresent(key, fn);
+    }
+
+    bool putIfAbsent(const Key& key, const Value& value)
+    {
+        return slices_[sliceIndex(key)]->putIfAbsent(key, value);
+    }
+
+    bool compareAndSet(const Key& key, const Value& expected, const Value& desired)
+    {
+        return slices_[sliceIndex(key)]->compareAndSet(key, expected, desired);
+    }
+
+    // key 所在分片属于哪个节点
+    int nodeOf(const Key& key) const
+    {
+        return static_cast<int>(sliceIndex(key)) / slicesPerNode_;
+    }
+
+    // 线程亲和：把当前线程绑到节点上，之后只处理 nodeOf(key) == node 的请求
+    static bool bindCurrentThread(int node)
+    {
+        return NumaTopology::bindCurrentThread(node);
+    }
+
+    int nodeCount() const { return nodeCount_; }
+
+    // 所有节点都已分配过且 mbind 成功
+    bool nodeLocal() const
+    {
+        for (auto& resource : nodeResources_)
+        {
+            if (!resource->bound()) return false;
+        }
+        return true;
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    void clear()
+    {
+        for (auto& slice : slices_)
+        {
+            slice->clear();
+        }
+    }
+
+    size_t size() const
+    {
+        size_t total = 0;
+        for (auto& slice : slices_)
+        {
+            total += slice->size();
+        }
+        return total;
+    }
+
+private:
+    size_t sliceIndex(const Key& key) const
+    {
+        return std::hash<Key>()(key) % sliceNum_;
+    }
+
+private:
+    size_t capacity_;
+    int nodeCount_;
+    int slicesPerNode_;
+    int sliceNum_;
+    // 析构顺序与声明相反：先销毁分片，再销毁内存池和上游资源
+    std::vector<std::unique_ptr<NumaNodeResource>> nodeResources_;
+    std::vector<std::unique_ptr<std::pmr::synchronized_pool_resource>> pools_;
+    std::vector<std::unique_ptr<LRUCache<Key, Value>>> slices_;
+};
+
+} // namespace CacheDemo
@@ -0,0 +1,554 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include "Cachepolicy.h"
+
+namespace CacheDemo
+{
+
+// 基于策略的缓存：淘汰、索引、加锁、统计四个维度在编译期组合，
+// 热路径上没有虚函数调用，单线程场景可选 NoLocking 去掉锁。
+//
+// 淘汰策略需提供 Impl<Key, Value>，负责存放条目并以 Handle 标识：
+//   Impl(size_t capacity);
+//   Handle insert(const Key&, const Value&);  // 插入新条目
+//   void touch(Handle);                        // 命中后更新位置/频率
+//   Value& value(Handle);
+//   bool evict(Key& victim);                   // 淘汰一个条目，传出其 key
+//   size_t size() const;
+// 索引策略需提供 Map<Key, Handle>，接口与 std::unordered_map 的 find/emplace/erase 相同
+
+// ---------------- 淘汰策略 ----------------
+
+struct FIFOEviction
+{
+    template<typename Key, typename Value>
+    class Impl
+    {
+    private:
+        using List = std::list<std::pair<Key, Value>>;
+
+    public:
+        using Handle = typename List::iterator;
+
+        explicit Impl(size_t) {}
+
+        Handle insert(const Key& key, const Value& value)
+        {
+            list_.emplace_front(key, value);
+            return list_.begin();
+        }
+
+        void touch(Handle) {}
+
+        Value& value(Handle handle) { return handle->second; }
+
+        bool evict(Key& victim)
+        {
+            if (list_.empty()) return false;
+            victim = std::move(list_.back().first);
+            list_.pop_back();
+            return true;
+        }
+
+        size_t size() const { return list_.size(); }
+
+    private:
+        List list_;
+    };
+};
+
+struct LRUEviction
+{
+    template<typename Key, typename Value>
+    class Impl
+    {
+    private:
+        using List = std::list<std::pair<Key, Value>>;
+
+    public:
+        using Handle = typename List::iterator;
+
+        explicit Impl(size_t) {}
+
+        Handle insert(const Key& key, const Value& value)
+        {
+            list_.emplace_front(key, value);
+            return list_.begin();
+        }
+
+        void touch(Handle handle)
+        {
+            list_.splice(list_.begin(), list_, handle);
+        }
+
+        Value& value(Handle handle) { return handle->second; }
+
+        bool evict(Key& victim)
+        {
+            if (list_.empty()) return false;
+            victim = std::move(list_.back().first);
+            list_.pop_back();
+            return true;
+        }
+
+        size_t size() const { return list_.size(); }
+
+    private:
+        List list_;
+    };
+};
+
+// 按频率分桶，同频率内按 LRU 淘汰；节点在桶之间 splice，Handle 始终有效
+struct LFUEviction
+{
+    template<typename Key, typename Value>
+    class Impl
+    {
+    private:
+        struct Node
+        {
+            Key key;
+            Value value;
+            size_t freq;
+        };
+        using List = std::list<Node>;
+
+    public:
+        using Handle = typename List::iterator;
+
+        explicit Impl(size_t) : minFreq_(1), size_(0) {}
+
+        Handle insert(const Key& key, const Value& value)
+        {
+            List& bucket = buckets_[1];
+            bucket.push_back(Node{key, value, 1});
+            minFreq_ = 1;
+            ++size_;
+            return std::prev(bucket.end());
+        }
+
+        void touch(Handle handle)
+        {
+            size_t freq = handle->freq;
+            // 插入新桶可能触发 rehash，只持引用不持迭代器
+            List& from = buckets_.find(freq)->second;
+            List& to = buckets_[freq + 1];
+            to.splice(to.end(), from, handle);
+            ++handle->freq;
+            if (from.empty())
+            {
+                buckets_.erase(freq);
+                if (minFreq_ == freq) minFreq_ = freq + 1;
+            }
+        }
+
+        Value& value(Handle handle) { return handle->value; }
+
+        bool evict(Key& victim)
+        {
+            if (size_ == 0) return false;
+            auto it = buckets_.find(minFreq_);
+            victim = std::move(it->second.front().key);
+            it->second.pop_front();
+            if (it->second.empty()) buckets_.erase(it);
+            --size_;
+            // 淘汰后必然紧跟一次 insert，minFreq_ 会被重置为 1
+            return true;
+        }
+
+        size_t size() const { return size_; }
+
+    private:
+        std::unordered_map<size_t, List> buckets_;
+        size_t minFreq_;
+        size_t size_;
+    };
+};
+
+// 简化版 ARC：T1（只访问过一次）、T2（多次访问）两条 LRU 链，
+// 加上各自的 ghost 链 B1/B2 调整目标值 p。与原版的区别是
+// ghost 命中时的 p 调整发生在淘汰之后，对本次淘汰不起作用
+struct ARCEviction
+{
+    template<typename Key, typename Value>
+    class Impl
+    {
+    private:
+        struct Node
+        {
+            Key key;
+            Value value;
+            bool frequent;
+        };
+        using List = std::list<Node>;
+
+        struct Ghost
+        {
+            std::list<Key> keys;
+            std::unordered_map<Key, typename std::list<Key>::iterator> index;
+
+            bool take(const Key& key)
+            {
+                auto it = index.find(key);
+                if (it == index.end()) return false;
+                keys.erase(it->second);
+                index.erase(it);
+                return true;
+            }
+
+            void add(const Key& key, size_t limit)
+            {
+                keys.push_front(key);
+                index[key] = keys.begin();
+                if (keys.size() > limit)
+                {
+                    index.erase(keys.back());
+                    keys.pop_back();
+                }
+            }
+        };
+
+    public:
+        using Handle = typename List::iterator;
+
+        explicit Impl(size_t capacity) : capacity_(capacity > 0 ? capacity : 1), p_(0) {}
+
+        Handle insert(const Key& key, const Value& value)
+        {
+            if (b1_.take(key))
+            {
+                size_t delta = std::max<size_t>(b2_.keys.size() / (b1_.keys.size() + 1), 1);
+                p_ = std::min(capacity_, p_ + delta);
+                t2_.push_front(Node{key, value, true});
+                return t2_.begin();
+            }
+            if (b2_.take(key))
+            {
+                size_t delta = std::max<size_t>(b1_.keys.size() / (b2_.keys.size() + 1), 1);
+                p_ = p_ > delta ? p_ - delta : 0;
+                t2_.push_front(Node{key, value, true});
+                return t2_.begin();
+            }
+            t1_.push_front(Node{key, value, false});
+            return t1_.begin();
+        }
+
+        void touch(Handle handle)
+        {
+            List& from = handle->frequent ? t2_ : t1_;
+            t2_.splice(t2_.begin(), from, handle);
+            handle->frequent = true;
+        }
+
+        Value& value(Handle handle) { return handle->value; }
+
+        bool evict(Key& victim)
+        {
+            if (!t1_.empty() && (t1_.size() > p_ || t2_.empty()))
+            {
+                victim = t1_.back().key;
+                b1_.add(victim, capacity_);
+                t1_.pop_back();
+                return true;
+            }
+            if (!t2_.empty())
+            {
+                victim = t2_.back().key;
+                b2_.add(victim, capacity_);
+                t2_.pop_back();
+                return true;
+            }
+            return false;
+        }
+
+        size_t size() const { return t1_.size() + t2_.size(); }
+
+    private:
+        size_t capacity_;
+        size_t p_;  // T1 的目标大小
+        List t1_;
+        List t2_;
+        Ghost b1_;
+        Ghost b2_;
+    };
+};
+
+// ---------------- 索引策略 ----------------
+
+struct HashIndex
+{
+    template<typename Key, typename Handle>
+    using Map = std::unordered_map<Key, Handle>;
+};
+
+// 有序索引，适合哈希代价高或需要稳定最坏情况的 key
+struct TreeIndex
+{
+    template<typename Key, typename Handle>
+    using Map = std::map<Key, Handle>;
+};
+
+// ---------------- 加锁策略 ----------------
+
+struct MutexLocking
+{
+    void lock() { mutex_.lock(); }
+    void unlock() { mutex_.unlock(); }
+
+    std::mutex mutex_;
+};
+
+// 临界区很短时自旋比挂起线程便宜，拿不到锁时让出时间片
+struct SpinLocking
+{
+    void lock()
+    {
+        while (flag_.test_and_set(std::memory_order_acquire))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    void unlock() { flag_.clear(std::memory_order_release); }
+
+    std::atomic_flag flag_ = ATOMIC_FLAG_INIT;
+};
+
+// 单线程使用，加解锁编译为空
+struct NoLocking
+{
+    void lock() {}
+    void unlock() {}
+};
+
+// ---------------- 统计策略 ----------------
+
+struct NoStats
+{
+    void hit() {}
+    void miss() {}
+    void eviction() {}
+};
+
+struct CountingStats
+{
+    void hit() { hits_.fetch_add(1, std::memory_order_relaxed); }
+    void miss() { misses_.fetch_add(1, std::memory_order_relaxed); }
+    void eviction() { evictions_.fetch_add(1, std::memory_order_relaxed); }
+
+    size_t hits() const { return hits_.load(std::memory_order_relaxed); }
+    size_t misses() const { return misses_.load(std::memory_order_relaxed); }
+    size_t evictions() const { return evictions_.load(std::memory_order_relaxed); }
+
+    std::atomic<size_t> hits_{0};
+    std::atomic<size_t> misses_{0};
+    std::atomic<size_t> evictions_{0};
+};
+
+// ---------------- 组合 ----------------
+
+template<typename Key, typename Value,
+         typename Eviction = LRUEviction,
+         typename Index = HashIndex,
+         typename Locking = MutexLocking,
+         typename Stats = NoStats>
+class Cache
+{
+private:
+    using Policy = typename Eviction::template Impl<Key, Value>;
+    using Handle = typename Policy::Handle;
+    using Map = typename Index::template Map<Key, Handle>;
+
+public:
+    using KeyType = Key;
+    using ValueType = Value;
+
+    explicit Cache(size_t capacity) : capacity_(capacity), policy_(capacity) {}
+
+    Cache(const Cache&) = delete;
+    Cache& operator=(const Cache&) = delete;
+
+    void put(const Key& key, const Value& value)
+    {
+        if (capacity_ == 0) return;
+
+        std::lock_guard<Locking> lock(lock_);
+        auto it = index_.find(key);
+        if (it != index_.end())
+        {
+            policy_.value(it->second) = value;
+            policy_.touch(it->second);
+            return;
+        }
+
+        insertLocked(key, value);
+    }
+
+    bool get(const Key& key, Value& value)
+    {
+        std::lock_guard<Locking> lock(lock_);
+        auto it = index_.find(key);
+        if (it == index_.end())
+        {
+            stats_.miss();
+            return false;
+        }
+        stats_.hit();
+        policy_.touch(it->second);
+        value = policy_.value(it->second);
+        return true;
+    }
+
+    Value get(const Key& key)
+    {
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    // 读-改-写：一次加锁、一次索引查找；Fn 为模板参数，可整体内联
+    // fn(const Value* old) -> Value，old 为空表示 key 不存在
+    template<typename Fn>
+    Value compute(const Key& key, Fn&& fn)
+    {
+        std::lock_guard<Locking> lock(lock_);
+        auto it = index_.find(key);
+        if (it != index_.end())
+        {
+            Value& current = policy_.value(it->second);
+            current = fn(static_cast<const Value*>(&current));
+            policy_.touch(it->second);
+            return current;
+        }
+        Value value = fn(static_cast<const Value*>(nullptr));
+        insertLocked(key, value);
+        return value;
+    }
+
+    template<typename Fn>
+    bool computeIfPresent(const Key& key, Fn&& fn)
+    {
+        std::lock_guard<Locking> lock(lock_);
+        auto it = index_.find(key);
+        if (it == index_.end()) return false;
+        Value& current = policy_.value(it->second);
+        current = fn(static_cast<const Value&>(current));
+        policy_.touch(it->second);
+        return true;
+    }
+
+    bool putIfAbsent(const Key& key, const Value& value)
+    {
+        if (capacity_ == 0) return false;
+        std::lock_guard<Locking> lock(lock_);
+        if (index_.find(key) != index_.end()) return false;
+        insertLocked(key, value);
+        return true;
+    }
+
+    bool compareAndSet(const Key& key, const Value& expected, const Value& desired)
+    {
+        std::lock_guard<Locking> lock(lock_);
+        auto it = index_.find(key);
+        if (it == index_.end() || !(policy_.value(it->second) == expected)) return false;
+        policy_.value(it->second) = desired;
+        policy_.touch(it->second);
+        return true;
+    }
+
+    size_t size()
+    {
+        std::lock_guard<Locking> lock(lock_);
+        return policy_.size();
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    // 持锁只交换出淘汰结构和索引，旧数据在锁外析构
+    void clear()
+    {
+        Policy policy(capacity_);
+        Map index;
+        {
+            std::lock_guard<Locking> lock(lock_);
+            std::swap(policy, policy_);
+            index.swap(index_);
+        }
+    }
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    // 插入新 key，满了先淘汰（需持锁调用）
+    void insertLocked(const Key& key, const Value& value)
+    {
+        if (capacity_ == 0) return;
+        if (policy_.size() >= capacity_)
+        {
+            Key victim;
+            if (policy_.evict(victim))
+            {
+                index_.erase(victim);
+                stats_.eviction();
+            }
+        }
+        index_.emplace(key, policy_.insert(key, value));
+    }
+
+private:
+    size_t capacity_;
+    Policy policy_;
+    Map index_;
+    Locking lock_;
+    Stats stats_;
+};
+
+// 类型擦除适配器：把任意编译期组合的缓存包装成 Cachepolicy，供按接口使用的代码调用
+template<typename CacheType>
+class CachepolicyAdapter : public Cachepolicy<typename CacheType::KeyType, typename CacheType::ValueType>
+{
+public:
+    using Key = typename CacheType::KeyType;
+    using Value = typename CacheType::ValueType;
+
+    template<typename... Args>
+    explicit CachepolicyAdapter(Args&&... args) : cache_(std::forward<Args>(args)...) {}
+
+    void put(const Key& key, const Value& value) override { cache_.put(key, value); }
+
+    bool get(const Key& key, Value& value) override { return cache_.get(key, value); }
+
+    void clear() override { cache_.clear(); }
+
+    Value compute(const Key& key, const typename Cachepolicy<Key, Value>::ComputeFn& fn) override
+    {
+        return cache_.compute(key, fn);
+    }
+
+    bool computeIfPresent(const Key& key, const typename Cachepolicy<Key, Value>::UpdateFn& fn) override
+    {
+        return cache_.computeIfPresent(key, fn);
+    }
+
+    bool putIfAbsent(const Key& key, const Value& value) override { return cache_.putIfAbsent(key, value); }
+
+    bool compareAndSet(const Key& key, const Value& expected, const Value& desired) override
+    {
+        return cache_.compareAndSet(key, expected, desired);
+    }
+
+    CacheType& cache() { return cache_; }
+
+private:
+    CacheType cache_;
+};
+
+} // namespace CacheDemo
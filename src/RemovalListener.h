@@ -0,0 +1,167 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace CacheDemo
+{
+
+// 数据离开缓存的原因
+enum class RemovalCause
+{
+    Capacity,   // 容量不足被淘汰
+    Explicit,   // 调用 deletenode 主动删除
+    Replaced,   // 被同 key 的 put 覆盖
+    Expired     // 过期（为带 TTL 的策略预留）
+};
+
+template<typename Key, typename Value>
+struct RemovalNotification
+{
+    Key key;
+    Value value;
+    RemovalCause cause;
+};
+
+// 移除事件分发器：
+// 缓存在锁内只做一次无锁入队（MPSC 队列），
+// 由后台线程批量取出后调用监听器，监听器永远不会在缓存锁内执行。
+// 后台线程空闲时在条件变量上无限期等待，只有它真正睡着时生产者才需要加锁唤醒
+template<typename Key, typename Value>
+class RemovalDispatcher
+{
+public:
+    using Notification = RemovalNotification<Key, Value>;
+    using Listener = std::function<void(const std::vector<Notification>&)>;
+
+    explicit RemovalDispatcher(Listener listener, size_t maxBatch = 256)
+        : listener_(std::move(listener)),
+          maxBatch_(maxBatch > 0 ? maxBatch : 1),
+          head_(new QNode),
+          tail_(head_.load()),
+          published_(0),
+          delivered_(0),
+          sleeping_(false),
+          stop_(false),
+          worker_([this]() { run(); })
+    {}
+
+    ~RemovalDispatcher()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cond_.notify_all();
+        worker_.join();
+        delete tail_;
+    }
+
+    RemovalDispatcher(const RemovalDispatcher&) = delete;
+    RemovalDispatcher& operator=(const RemovalDispatcher&) = delete;
+
+    // 生产者入队，可在缓存锁内调用：一次分配 + 一次原子交换
+    void publish(Key key, Value value, RemovalCause cause)
+    {
+        QNode* node = new QNode;
+        node->item = Notification{std::move(key), std::move(value), cause};
+        node->next.store(nullptr, std::memory_order_relaxed);
+        QNode* prev = head_.exchange(node, std::memory_order_acq_rel);
+        // 链接与读 sleeping_ 都用 seq_cst，与后台线程的“置 sleeping_ 再查队列”配对，
+        // 两边至少有一边看到对方，不会丢失唤醒
+        prev->next.store(node, std::memory_order_seq_cst);
+        published_.fetch_add(1, std::memory_order_relaxed);
+
+        if (sleeping_.load(std::memory_order_seq_cst))
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cond_.notify_one();
+        }
+    }
+
+    // 阻塞直到此前发布的事件都已交给监听器
+    void flush()
+    {
+        size_t target = published_.load(std::memory_order_relaxed);
+        std::unique_lock<std::mutex> lock(mutex_);
+        drained_.wait(lock, [this, target]() {
+            return delivered_.load(std::memory_order_acquire) >= target;
+        });
+    }
+
+private:
+    struct QNode
+    {
+        std::atomic<QNode*> next{nullptr};
+        Notification item{};
+    };
+
+    // 仅由后台线程调用
+    bool pop(Notification& out)
+    {
+        QNode* tail = tail_;
+        QNode* next = tail->next.load(std::memory_order_acquire);
+        if (next == nullptr) return false;
+
+        out = std::move(next->item);
+        tail_ = next;  // next 成为新的哨兵
+        delete tail;
+        return true;
+    }
+
+    void run()
+    {
+        std::vector<Notification> batch;
+        batch.reserve(maxBatch_);
+        while (true)
+        {
+            Notification item;
+            while (batch.size() < maxBatch_ && pop(item))
+            {
+                batch.push_back(std::move(item));
+            }
+
+            if (!batch.empty())
+            {
+                listener_(batch);
+                delivered_.fetch_add(batch.size(), std::memory_order_release);
+                batch.clear();
+                // flush 在锁内检查 delivered_，这里过一下锁再通知即可避免丢失唤醒
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                }
+                drained_.notify_all();
+                continue;
+            }
+
+            // 队列为空：先声明要睡眠再复查队列，之后无限期等待生产者或析构唤醒
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (stop_ && tail_->next.load(std::memory_order_acquire) == nullptr) break;
+            sleeping_.store(true, std::memory_order_seq_cst);
+            cond_.wait(lock, [this]() {
+                return stop_ || tail_->next.load(std::memory_order_seq_cst) != nullptr;
+            });
+            sleeping_.store(false, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    Listener listener_;
+    size_t maxBatch_;
+    std::atomic<QNode*> head_;  // 生产者端
+    QNode* tail_;               // 消费者端
+    std::atomic<size_t> published_;
+    std::atomic<size_t> delivered_;
+    std::atomic<bool> sleeping_;  // 后台线程已在 cond_ 上等待（或即将等待）
+    bool stop_;
+    std::mutex mutex_;
+    std::condition_variable cond_;    // 唤醒后台线程
+    std::condition_variable drained_; // 通知 flush 有一批事件已交付
+    std::thread worker_;  // 必须最后初始化
+};
+
+} // namespace CacheDemo
@@ -0,0 +1,507 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include "CacheExecutor.h"
+#include "Cachepolicy.h"
+#include "EpochReclaim.h"
+#include "HashUtil.h"
+
+namespace CacheDemo
+{
+
+// 有界 MPMC 环形队列（Vyukov）：入队/出队各只需一次 CAS 抢占位置
+template<typename T>
+class MPMCRing
+{
+private:
+    struct Cell
+    {
+        std::atomic<size_t> seq;
+        T data;
+    };
+
+public:
+    explicit MPMCRing(size_t capacity)
+        : mask_(roundUpPow2(capacity < 2 ? 2 : capacity) - 1),
+          cells_(new Cell[mask_ + 1]),
+          head_(0),
+          tail_(0)
+    {
+        for (size_t i = 0; i <= mask_; ++i)
+        {
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPMCRing(const MPMCRing&) = delete;
+    MPMCRing& operator=(const MPMCRing&) = delete;
+
+    bool push(const T& value)
+    {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true)
+        {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            }
+            else if (diff < 0)
+            {
+                return false;  // 已满
+            }
+            else
+            {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = value;
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& value)
+    {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true)
+        {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            }
+            else if (diff < 0)
+            {
+                return false;  // 为空
+            }
+            else
+            {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+        value = cell->data;
+        cell->seq.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 近似长度，并发时仅供参考
+    size_t size() const
+    {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t head = head_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+private:
+    size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<size_t> head_;
+    alignas(64) std::atomic<size_t> tail_;
+};
+
+// S3-FIFO：小 FIFO（约 10%）+ 主 FIFO（约 90%）+ 只存 key 的 ghost FIFO。
+// 新 key 进小队列，在小队列期间被再次访问过的才晋升主队列，否则只留 key 在 ghost 中；
+// 命中 ghost 的 key 直接进主队列；主队列出队时频率非 0 的减一后重新入队。
+// get 完全无锁（纪元保护下查并发索引，频率用普通 store 近似累加，最大 3）；
+// 队列操作只有 CAS，索引写入使用 ConcurrentHashIndex 的分条桶锁。
+// 索引和队列合起来是一代 State，clear 时整体换成新的一代，旧一代过宽限期后交给执行器析构
+template<typename Key, typename Value>
+class S3FIFOCache : public Cachepolicy<Key, Value>
+{
+private:
+    struct Entry
+    {
+        Key key;
+        Value value;
+        std::atomic<uint8_t> freq;
+        std::atomic<bool> removed;  // 已被同 key 的新值替换，出队时直接丢弃
+        std::atomic<bool> inMain;
+
+        Entry(const Key& k, const Value& v)
+            : key(k), value(v), freq(0), removed(false), inMain(false) {}
+    };
+
+    // 一代索引与队列，每个操作在纪元保护下只使用进入时看到的那一代
+    struct State
+    {
+        State(size_t capacity, const std::shared_ptr<EpochManager>& epoch)
+            : index(capacity, epoch),
+              ghostIndex(capacity, epoch),
+              small(capacity * 2),
+              main(capacity * 2),
+              ghost(capacity),
+              live(0),
+              ghostSeq(0)
+        {}
+
+        // 仍在队列中的条目（包括已被替换、尚未出队的）都归这一代所有
+        ~State()
+        {
+            Entry* entry;
+            while (small.pop(entry)) delete entry;
+            while (main.pop(entry)) delete entry;
+        }
+
+        ConcurrentHashIndex<Key, Entry*> index;
+        ConcurrentHashIndex<Key, uint64_t> ghostIndex;  // key -> 最近一次记入 ghost 的序号
+        MPMCRing<Entry*> small;
+        MPMCRing<Entry*> main;
+        MPMCRing<std::pair<Key, uint64_t>> ghost;     // 同一 key 可能出现多次，只有序号相同的那次有效
+        std::atomic<size_t> live;  // 索引中的有效条目数
+        std::atomic<uint64_t> ghostSeq;
+        std::shared_ptr<CacheExecutor> executor;  // 被换出后负责析构它的执行器
+    };
+
+    static constexpr uint8_t MAX_FREQ_BITS = 3;  // 2 bit 频率
+
+public:
+    using ComputeFn = typename Cachepolicy<Key, Value>::ComputeFn;
+    using UpdateFn = typename Cachepolicy<Key, Value>::UpdateFn;
+
+    explicit S3FIFOCache(size_t capacity, double smallRatio = 0.1)
+        : capacity_(capacity),
+          smallCapacity_(capacity * smallRatio < 1 ? 1 : static_cast<size_t>(capacity * smallRatio)),
+          epoch_(std::make_shared<EpochManager>()),
+          state_(newState())
+    {}
+
+    ~S3FIFOCache() override
+    {
+        delete state_.load(std::memory_order_relaxed);
+    }
+
+    void put(const Key& key, const Value& value) override
+    {
+        if (capacity_ == 0) return;
+
+        auto guard = epoch_->pin();
+        State& state = current();
+        Entry* entry = new Entry(key, value);
+        Entry* old = nullptr;
+        if (!state.index.insertOrAssign(key, entry, &old))
+        {
+            // 覆盖：继承旧节点的频率和所在队列，旧节点出队时丢弃
+            inherit(entry, old);
+        }
+        link(state, entry, old);
+    }
+
+    // 以下读-改-写操作在 key 所在的索引桶锁内决定新值并发布新节点，
+    // 与同一 key 上的其他写入互斥，读不受影响；fn 在桶锁内执行，不能再访问本缓存
+    Value compute(const Key& key, const ComputeFn& fn) override
+    {
+        if (capacity_ == 0) return fn(nullptr);
+
+        auto guard = epoch_->pin();
+        State& state = current();
+        Value value;
+        Entry* entry = nullptr;
+        Entry* old = nullptr;
+        state.index.update(key, [&](Entry* const* current, Entry*& next) {
+            old = current != nullptr ? *current : nullptr;
+            value = fn(old != nullptr ? &old->value : nullptr);
+            next = entry = newEntry(key, value, old);
+            return true;
+        });
+        link(state, entry, old);
+        return value;
+    }
+
+    bool computeIfPresent(const Key& key, const UpdateFn& fn) override
+    {
+        return update(key, [&fn](const Entry* current, Value& value) {
+            if (current == nullptr) return false;
+            value = fn(current->value);
+            return true;
+        });
+    }
+
+    bool putIfAbsent(const Key& key, const Value& value) override
+    {
+        return update(key, [&value](const Entry* current, Value& next) {
+            if (current != nullptr) return false;
+            next = value;
+            return true;
+        });
+    }
+
+    bool compareAndSet(const Key& key, const Value& expected, const Value& desired) override
+    {
+        return update(key, [&](const Entry* current, Value& next) {
+            if (current == nullptr || !(current->value == expected)) return false;
+            next = desired;
+            return true;
+        });
+    }
+
+    bool get(const Key& key, Value& value) override
+    {
+        auto guard = epoch_->pin();
+        Entry* entry = nullptr;
+        if (!current().index.find(key, entry)) return false;
+
+        value = entry->value;
+        uint8_t freq = entry->freq.load(std::memory_order_relaxed);
+        if (freq < MAX_FREQ_BITS)
+        {
+            entry->freq.store(freq + 1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    Value get(const Key& key)
+    {
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    size_t size() const
+    {
+        auto guard = epoch_->pin();
+        return current().live.load(std::memory_order_relaxed);
+    }
+
+    // 清空：原子地换上新的一代，读写不被阻塞；
+    // 旧一代仍可能被进行中的操作使用，交给纪元回收，宽限期过后再整体交给执行器析构。
+    // 与 clear 并发的写入可能落在旧一代中随之丢弃，等同于发生在 clear 之前
+    void clear() override
+    {
+        State* fresh = newState();
+        State* old = state_.exchange(fresh, std::memory_order_acq_rel);
+        old->executor = executor_;
+        epoch_->retire(static_cast<void*>(old), &releaseState);
+    }
+
+    // 设置后台维护执行器：clear 换出的旧一代改由后台线程析构
+    // 需在缓存投入使用前设置
+    void setExecutor(std::shared_ptr<CacheExecutor> executor)
+    {
+        executor_ = std::move(executor);
+    }
+
+private:
+    // 各代的索引只借用纪元管理器、不持有它：
+    // 待回收的旧一代挂在纪元域里，持有会形成环，缓存销毁后旧一代永远等不到释放
+    State* newState() const
+    {
+        std::shared_ptr<EpochManager> epoch(epoch_.get(), [](EpochManager*) {});
+        return new State(capacity_, epoch);
+    }
+
+    State& current() const
+    {
+        return *state_.load(std::memory_order_acquire);
+    }
+
+    // 宽限期过后由纪元回收调用；执行器的引用先取出来，避免最后一个引用在执行器线程上释放
+    static void releaseState(void* ptr)
+    {
+        std::unique_ptr<State> state(static_cast<State*>(ptr));
+        std::shared_ptr<CacheExecutor> executor = std::move(state->executor);
+        releaseLater(executor.get(), std::move(state));
+    }
+
+    static void inherit(Entry* entry, const Entry* old)
+    {
+        entry->freq.store(old->freq.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        entry->inMain.store(old->inMain.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    static Entry* newEntry(const Key& key, const Value& value, const Entry* old)
+    {
+        Entry* entry = new Entry(key, value);
+        if (old != nullptr) inherit(entry, old);
+        return entry;
+    }
+
+    // fn(current, value) 在桶锁内决定是否写入及写入的值，返回是否写入
+    template<typename Fn>
+    bool update(const Key& key, Fn&& fn)
+    {
+        if (capacity_ == 0) return false;
+
+        auto guard = epoch_->pin();
+        State& state = current();
+        Entry* entry = nullptr;
+        Entry* old = nullptr;
+        bool written = state.index.update(key, [&](Entry* const* current, Entry*& next) {
+            old = current != nullptr ? *current : nullptr;
+            Value value;
+            if (!fn(old, value)) return false;
+            next = entry = newEntry(key, value, old);
+            return true;
+        });
+        if (written) link(state, entry, old);
+        return written;
+    }
+
+    // 新节点已发布到索引后入队：覆盖时丢弃旧节点，新插入时检查 ghost 并在超出容量时淘汰
+    void link(State& state, Entry* entry, Entry* old)
+    {
+        if (old != nullptr)
+        {
+            old->removed.store(true, std::memory_order_release);
+            enqueue(state, entry);
+            return;
+        }
+
+        if (state.ghostIndex.erase(entry->key))
+        {
+            entry->inMain.store(true, std::memory_order_relaxed);
+        }
+        enqueue(state, entry);
+        state.live.fetch_add(1, std::memory_order_relaxed);
+
+        // 并发淘汰时节点可能暂时不在任何队列中，淘汰不到就留给后续 put 补上
+        while (state.live.load(std::memory_order_relaxed) > capacity_ && evict(state))
+        {
+        }
+    }
+
+    void enqueue(State& state, Entry* entry)
+    {
+        push(state, entry->inMain.load(std::memory_order_relaxed), entry);
+    }
+
+    // 入队失败时先整理队列回收被替换的旧节点，只有确实超出容量才淘汰存活条目
+    void push(State& state, bool inMain, Entry* entry)
+    {
+        MPMCRing<Entry*>& queue = inMain ? state.main : state.small;
+        while (!queue.push(entry))
+        {
+            if (compact(state, queue)) continue;
+            if (inMain) evictMain(state); else evictSmall(state);
+        }
+    }
+
+    // 覆盖写会在队列里留下 removed 节点而不改变 live，队列可能被它们占满。
+    // 把当前队列中的节点依次出队：removed 的交给纪元回收，存活的按原顺序重新入队。
+    // 重新入队的位置被并发入队抢走时只能淘汰该节点；返回是否腾出了位置
+    bool compact(State& state, MPMCRing<Entry*>& queue)
+    {
+        bool freed = false;
+        size_t n = queue.size();
+        Entry* entry;
+        for (size_t i = 0; i < n && queue.pop(entry); ++i)
+        {
+            if (entry->removed.load(std::memory_order_acquire))
+            {
+                epoch_->retire(entry);
+                freed = true;
+            }
+            else if (!queue.push(entry))
+            {
+                drop(state, entry);
+                freed = true;
+            }
+        }
+        return freed;
+    }
+
+    // 淘汰一个条目，返回是否真的淘汰到了
+    bool evict(State& state)
+    {
+        if (state.small.size() >= smallCapacity_ || state.main.size() == 0)
+        {
+            return evictSmall(state);
+        }
+        return evictMain(state);
+    }
+
+    // 小队列出队：被再次访问过的晋升主队列，否则淘汰并记入 ghost
+    bool evictSmall(State& state)
+    {
+        Entry* entry;
+        while (state.small.pop(entry))
+        {
+            if (entry->removed.load(std::memory_order_acquire))
+            {
+                epoch_->retire(entry);
+                continue;
+            }
+
+            if (entry->freq.load(std::memory_order_relaxed) > 1)
+            {
+                entry->inMain.store(true, std::memory_order_relaxed);
+                entry->freq.store(0, std::memory_order_relaxed);
+                push(state, true, entry);
+                continue;
+            }
+
+            recordGhost(state, entry->key);
+            drop(state, entry);
+            return true;
+        }
+        // 小队列已空，从主队列淘汰
+        return state.main.size() > 0 && evictMain(state);
+    }
+
+    // 主队列出队：频率非 0 的减一后重新入队（二次机会），为 0 的淘汰
+    bool evictMain(State& state)
+    {
+        Entry* entry;
+        while (state.main.pop(entry))
+        {
+            if (entry->removed.load(std::memory_order_acquire))
+            {
+                epoch_->retire(entry);
+                continue;
+            }
+
+            uint8_t freq = entry->freq.load(std::memory_order_relaxed);
+            if (freq > 0)
+            {
+                entry->freq.store(freq - 1, std::memory_order_relaxed);
+                if (state.main.push(entry)) continue;
+            }
+
+            drop(state, entry);
+            return true;
+        }
+        return false;
+    }
+
+    // 从索引摘除后交给纪元回收；索引里若已是新节点则只回收旧节点
+    void drop(State& state, Entry* entry)
+    {
+        if (state.index.erase(entry->key, entry))
+        {
+            state.live.fetch_sub(1, std::memory_order_relaxed);
+        }
+        epoch_->retire(entry);
+    }
+
+    // ghost 队列出队的旧记录只在序号仍与索引一致时才删除，同一 key 更新的记录不受影响
+    void recordGhost(State& state, const Key& key)
+    {
+        uint64_t seq = state.ghostSeq.fetch_add(1, std::memory_order_relaxed) + 1;
+        state.ghostIndex.insertOrAssign(key, seq);
+        while (!state.ghost.push(std::make_pair(key, seq)))
+        {
+            std::pair<Key, uint64_t> oldest;
+            if (state.ghost.pop(oldest)) state.ghostIndex.erase(oldest.first, oldest.second);
+        }
+    }
+
+private:
+    size_t capacity_;
+    size_t smallCapacity_;
+    std::shared_ptr<EpochManager> epoch_;
+    std::atomic<State*> state_;  // 当前一代，clear 时整体替换
+    std::shared_ptr<CacheExecutor> executor_;
+};
+
+} // namespace CacheDemo
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <unordered_map>
+#include "Cachepolicy.h"
+#include "IndexList.h"
+
+namespace CacheDemo
+{
+
+// 分段 LRU：新 key 先进试用段，在试用段中再次被访问才晋升保护段；
+// 保护段满时把其尾部降回试用段头部，淘汰总是先取试用段尾部。
+// 只访问一次的扫描数据停留在试用段，冲不掉保护段中的热数据，命中开销与 LRU 相同
+template<typename Key, typename Value>
+class SLRUCache : public Cachepolicy<Key, Value>
+{
+private:
+    struct Node
+    {
+        Key key{};
+        Value value{};
+        bool isProtected = false;
+        IndexLink link;
+    };
+
+    using SegmentList = IndexList<Node, &Node::link>;
+
+public:
+    using ComputeFn = typename Cachepolicy<Key, Value>::ComputeFn;
+    using UpdateFn = typename Cachepolicy<Key, Value>::UpdateFn;
+    using Index = std::pmr::unordered_map<Key, uint32_t>;
+
+    // protectedRatio: 保护段占容量的比例，试用段至少保留 1 个位置；resource 用于 key 索引
+    explicit SLRUCache(size_t capacity, double protectedRatio = 0.8,
+                       std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : capacity_(capacity),
+          protectedCapacity_(protectedCapacityOf(capacity, protectedRatio)),
+          pool_(capacity),
+          index_(resource)
+    {
+        index_.reserve(capacity);
+    }
+
+    ~SLRUCache() override = default;
+
+    void put(const Key& key, const Value& value) override
+    {
+        if (capacity_ == 0) return;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it != index_.end())
+        {
+            pool_[it->second].value = value;
+            touch(it->second);
+            return;
+        }
+        insert(key, value);
+    }
+
+    bool get(const Key& key, Value& value) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end()) return false;
+
+        value = pool_[it->second].value;
+        touch(it->second);
+        return true;
+    }
+
+    Value get(const Key& key)
+    {
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    // 以下读-改-写操作一次加锁完成，fn 在锁内执行，不能再访问本缓存
+    Value compute(const Key& key, const ComputeFn& fn) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it != index_.end())
+        {
+            Node& node = pool_[it->second];
+            node.value = fn(&node.value);
+            touch(it->second);
+            return node.value;
+        }
+        Value value = fn(nullptr);
+        if (capacity_ > 0) insert(key, value);
+        return value;
+    }
+
+    bool computeIfPresent(const Key& key, const UpdateFn& fn) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end()) return false;
+
+        Node& node = pool_[it->second];
+        node.value = fn(node.value);
+        touch(it->second);
+        return true;
+    }
+
+    bool putIfAbsent(const Key& key, const Value& value) override
+    {
+        if (capacity_ == 0) return false;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (index_.count(key)) return false;
+        insert(key, value);
+        return true;
+    }
+
+    bool compareAndSet(const Key& key, const Value& expected, const Value& desired) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end() || !(pool_[it->second].value == expected)) return false;
+
+        pool_[it->second].value = desired;
+        touch(it->second);
+        return true;
+    }
+
+    // 新的节点池和索引在锁外准备好，持锁只做交换，旧数据在锁外释放
+    void clear() override
+    {
+        NodePool<Node> pool(pool_.size());
+        Index index(index_.get_allocator());
+        index.reserve(capacity_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pool.swap(pool_);
+            index.swap(index_);
+            probation_ = SegmentList();
+            protected_ = SegmentList();
+        }
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    size_t size()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return index_.size();
+    }
+
+    // 保护段当前条目数
+    size_t protectedSize()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return protected_.size;
+    }
+
+private:
+    static size_t protectedCapacityOf(size_t capacity, double protectedRatio)
+    {
+        if (capacity < 2) return 0;
+        size_t size = static_cast<size_t>(capacity * protectedRatio);
+        return std::min(size, capacity - 1);
+    }
+
+    // 命中：试用段晋升保护段，保护段移到头部（需持锁调用）
+    void touch(uint32_t i)
+    {
+        Node& node = pool_[i];
+        if (node.isProtected)
+        {
+            protected_.moveToFront(pool_.data(), i);
+            return;
+        }
+        if (protectedCapacity_ == 0)
+        {
+            probation_.moveToFront(pool_.data(), i);
+            return;
+        }
+
+        probation_.unlink(pool_.data(), i);
+        protected_.pushFront(pool_.data(), i);
+        node.isProtected = true;
+        if (protected_.size > protectedCapacity_)
+        {
+            uint32_t demoted = protected_.tail;
+            protected_.unlink(pool_.data(), demoted);
+            probation_.pushFront(pool_.data(), demoted);
+            pool_[demoted].isProtected = false;
+        }
+    }
+
+    // 新 key 进试用段头部，满时先淘汰（需持锁调用）
+    void insert(const Key& key, const Value& value)
+    {
+        if (index_.size() >= capacity_) evict();
+
+        uint32_t i = pool_.acquire();
+        Node& node = pool_[i];
+        node.key = key;
+        node.value = value;
+        node.isProtected = false;
+        probation_.pushFront(pool_.data(), i);
+        index_.emplace(key, i);
+    }
+
+    // 淘汰试用段尾部；试用段为空时淘汰保护段尾部（需持锁调用）
+    void evict()
+    {
+        SegmentList& segment = probation_.empty() ? protected_ : probation_;
+        uint32_t victim = segment.tail;
+        segment.unlink(pool_.data(), victim);
+        Node& node = pool_[victim];
+        index_.erase(node.key);
+        node.value = Value{};
+        pool_.release(victim);
+    }
+
+private:
+    size_t capacity_;
+    size_t protectedCapacity_;
+    NodePool<Node> pool_;     // capacity 个节点，后续不再分配
+    Index index_;             // key -> 节点下标
+    SegmentList probation_;   // 试用段，head 为最近访问
+    SegmentList protected_;   // 保护段，head 为最近访问
+    std::mutex mutex_;
+};
+
+} // namespace CacheDemo
@@ -0,0 +1,372 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <vector>
+#include "Cachepolicy.h"
+#include "HashUtil.h"
+
+namespace CacheDemo
+{
+
+enum class SampledPolicy { LRU, LFU };
+
+// 采样淘汰缓存（近似 LRU/LFU，参照 Redis）：
+// 条目直接存放在开放寻址（线性探测）的平坦数组中，没有链表指针，也没有单独的哈希节点，
+// 每个条目只额外带 4 字节元数据：LRU 模式为 24 位访问时钟，LFU 模式为 8 位对数计数 + 16 位衰减时间。
+// 淘汰时随机采样 samples 个条目淘汰最差的一个；启用淘汰池时各次采样的候选会累积下来，近似效果更好。
+// get 只持共享锁，命中时原子更新元数据，读者之间互不阻塞；写入持独占锁
+template<typename Key, typename Value>
+class SampledCache : public Cachepolicy<Key, Value>
+{
+private:
+    static constexpr uint32_t OCCUPIED = 1u << 31;
+    static constexpr uint32_t CLOCK_MASK = (1u << 24) - 1;
+    static constexpr uint32_t LFU_INIT = 5;      // 新条目的初始计数，避免刚写入就被淘汰
+    static constexpr uint32_t LFU_LOG_FACTOR = 10;
+
+    struct Slot
+    {
+        Key key{};
+        Value value{};
+        std::atomic<uint32_t> meta{0};
+    };
+
+    struct Candidate
+    {
+        uint32_t score;  // 越大越应该淘汰
+        Key key;
+    };
+
+public:
+    using ComputeFn = typename Cachepolicy<Key, Value>::ComputeFn;
+    using UpdateFn = typename Cachepolicy<Key, Value>::UpdateFn;
+    using Table = std::pmr::vector<Slot>;
+
+    // samples: 每次淘汰采样的条目数，越大越接近精确 LRU/LFU，CPU 开销也越大；
+    // poolSize: 淘汰池大小，0 表示不使用；resource 用于条目数组
+    explicit SampledCache(size_t capacity, SampledPolicy policy = SampledPolicy::LRU,
+                          size_t samples = 5, size_t poolSize = 16,
+                          std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : capacity_(capacity),
+          policy_(policy),
+          samples_(std::max<size_t>(1, samples)),
+          poolSize_(poolSize),
+          mask_(tableSizeOf(capacity) - 1),
+          decayPeriod_(std::max<size_t>(1, capacity)),
+          table_(mask_ + 1, resource),
+          size_(0),
+          clock_(0),
+          rng_(std::random_device{}())
+    {
+        pool_.reserve(poolSize_ + samples_);
+    }
+
+    ~SampledCache() override = default;
+
+    void put(const Key& key, const Value& value) override
+    {
+        if (capacity_ == 0) return;
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        size_t i = find(key);
+        if (i != NOT_FOUND)
+        {
+            table_[i].value = value;
+            touch(table_[i]);
+            return;
+        }
+        insert(key, value);
+    }
+
+    bool get(const Key& key, Value& value) override
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        size_t i = find(key);
+        if (i == NOT_FOUND) return false;
+
+        value = table_[i].value;
+        touch(table_[i]);
+        return true;
+    }
+
+    Value get(const Key& key)
+    {
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    // 以下读-改-写操作持独占锁一次完成，fn 在锁内执行，不能再访问本缓存
+    Value compute(const Key& key, const ComputeFn& fn) override
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        size_t i = find(key);
+        if (i != NOT_FOUND)
+        {
+            table_[i].value = fn(&table_[i].value);
+            touch(table_[i]);
+            return table_[i].value;
+        }
+        Value value = fn(nullptr);
+        if (capacity_ > 0) insert(key, value);
+        return value;
+    }
+
+    bool computeIfPresent(const Key& key, const UpdateFn& fn) override
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        size_t i = find(key);
+        if (i == NOT_FOUND) return false;
+
+        table_[i].value = fn(table_[i].value);
+        touch(table_[i]);
+        return true;
+    }
+
+    bool putIfAbsent(const Key& key, const Value& value) override
+    {
+        if (capacity_ == 0) return false;
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (find(key) != NOT_FOUND) return false;
+        insert(key, value);
+        return true;
+    }
+
+    bool compareAndSet(const Key& key, const Value& expected, const Value& desired) override
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        size_t i = find(key);
+        if (i == NOT_FOUND || !(table_[i].value == expected)) return false;
+
+        table_[i].value = desired;
+        touch(table_[i]);
+        return true;
+    }
+
+    // 新数组在锁外分配好，持锁只做交换，旧数据在锁外释放
+    void clear() override
+    {
+        Table table(table_.size(), table_.get_allocator());
+        {
+            std::unique_lock<std::shared_mutex> lock(mutex_);
+            table.swap(table_);
+            pool_.clear();
+            size_ = 0;
+        }
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    size_t size()
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return size_;
+    }
+
+    // 条目数组占用的字节数（含元数据和空槽）
+    size_t tableBytes() const { return table_.size() * sizeof(Slot); }
+
+private:
+    static constexpr size_t NOT_FOUND = SIZE_MAX;
+
+    // 装载率不超过 3/4
+    static size_t tableSizeOf(size_t capacity)
+    {
+        return roundUpPow2(std::max<size_t>(2, capacity + capacity / 3 + 1));
+    }
+
+    // 打散后的哈希决定线性探测的起点
+    static size_t homeOf(const Key& key, size_t mask)
+    {
+        return mixHash(std::hash<Key>()(key)) & mask;
+    }
+
+    static bool occupied(const Slot& slot)
+    {
+        return slot.meta.load(std::memory_order_relaxed) & OCCUPIED;
+    }
+
+    size_t find(const Key& key) const
+    {
+        for (size_t i = homeOf(key, mask_); ; i = (i + 1) & mask_)
+        {
+            const Slot& slot = table_[i];
+            if (!occupied(slot)) return NOT_FOUND;
+            if (slot.key == key) return i;
+        }
+    }
+
+    uint32_t now() const { return clock_.load(std::memory_order_relaxed) & CLOCK_MASK; }
+
+    // 以写入次数为时钟；LFU 的衰减时间以 decayPeriod 次写入为一个单位
+    uint16_t decayNow() const
+    {
+        return static_cast<uint16_t>(clock_.load(std::memory_order_relaxed) / decayPeriod_);
+    }
+
+    // 按经过的衰减周期降低计数
+    uint32_t decayedCounter(uint32_t meta) const
+    {
+        uint32_t counter = meta & 0xFF;
+        uint16_t last = static_cast<uint16_t>((meta >> 8) & 0xFFFF);
+        uint16_t elapsed = static_cast<uint16_t>(decayNow() - last);
+        return counter > elapsed ? counter - elapsed : 0;
+    }
+
+    uint32_t lfuMeta(uint32_t counter) const
+    {
+        return OCCUPIED | (static_cast<uint32_t>(decayNow()) << 8) | counter;
+    }
+
+    // 命中时更新元数据，共享锁下多个读者可能并发调用
+    void touch(Slot& slot)
+    {
+        if (policy_ == SampledPolicy::LRU)
+        {
+            slot.meta.store(OCCUPIED | now(), std::memory_order_relaxed);
+            return;
+        }
+
+        // 对数计数：计数越大，再加一的概率越小
+        uint32_t meta = slot.meta.load(std::memory_order_relaxed);
+        uint32_t counter = decayedCounter(meta);
+        if (counter < 255)
+        {
+            uint32_t base = counter > LFU_INIT ? counter - LFU_INIT : 0;
+            thread_local std::minstd_rand rand(std::random_device{}());
+            if (rand() % (base * LFU_LOG_FACTOR + 1) == 0) ++counter;
+        }
+        slot.meta.compare_exchange_strong(meta, lfuMeta(counter), std::memory_order_relaxed);
+    }
+
+    // 淘汰分数：LRU 为空闲时长，LFU 为计数取反
+    uint32_t scoreOf(const Slot& slot) const
+    {
+        uint32_t meta = slot.meta.load(std::memory_order_relaxed);
+        if (policy_ == SampledPolicy::LRU)
+        {
+            return (now() - meta) & CLOCK_MASK;
+        }
+        return 255 - decayedCounter(meta);
+    }
+
+    // 需持独占锁调用，key 不存在
+    void insert(const Key& key, const Value& value)
+    {
+        if (size_ >= capacity_) evict();
+
+        size_t i = homeOf(key, mask_);
+        while (occupied(table_[i])) i = (i + 1) & mask_;
+
+        clock_.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = table_[i];
+        slot.key = key;
+        slot.value = value;
+        slot.meta.store(policy_ == SampledPolicy::LRU ? (OCCUPIED | now()) : lfuMeta(LFU_INIT),
+                        std::memory_order_relaxed);
+        ++size_;
+    }
+
+    // 随机采样若干条目，淘汰分数最高的一个（需持独占锁调用）
+    void evict()
+    {
+        // 淘汰池中的候选按分数升序排列，末尾最该淘汰；不使用淘汰池时每次重新采样
+        if (poolSize_ == 0) pool_.clear();
+
+        size_t sampled = 0;
+        for (size_t attempts = 0; sampled < samples_ && attempts < samples_ * 8; ++attempts)
+        {
+            const Slot& slot = table_[rng_() & mask_];
+            if (!occupied(slot)) continue;
+            ++sampled;
+            addCandidate(Candidate{scoreOf(slot), slot.key});
+        }
+
+        // 从池中取分数最高且仍然存在的候选；候选被删或被覆盖后可能已不在表中
+        while (!pool_.empty())
+        {
+            Candidate victim = std::move(pool_.back());
+            pool_.pop_back();
+            size_t i = find(victim.key);
+            if (i != NOT_FOUND)
+            {
+                erase(i);
+                return;
+            }
+        }
+
+        // 采样全部落空（表几乎为空时才会发生），顺序找一个条目淘汰
+        for (size_t i = 0; i <= mask_; ++i)
+        {
+            if (occupied(table_[i]))
+            {
+                erase(i);
+                return;
+            }
+        }
+    }
+
+    void addCandidate(Candidate candidate)
+    {
+        for (auto& existing : pool_)
+        {
+            if (existing.key == candidate.key)
+            {
+                existing.score = candidate.score;
+                std::sort(pool_.begin(), pool_.end(),
+                          [](const Candidate& a, const Candidate& b) { return a.score < b.score; });
+                return;
+            }
+        }
+        auto pos = std::upper_bound(pool_.begin(), pool_.end(), candidate,
+                                    [](const Candidate& a, const Candidate& b) { return a.score < b.score; });
+        pool_.insert(pos, std::move(candidate));
+        // 池满时丢掉分数最低的候选
+        if (poolSize_ > 0 && pool_.size() > poolSize_) pool_.erase(pool_.begin());
+    }
+
+    // 线性探测的后移删除：把后续探测链上能前移的条目前移，不留墓碑（需持独占锁调用）
+    void erase(size_t hole)
+    {
+        for (size_t j = (hole + 1) & mask_; occupied(table_[j]); j = (j + 1) & mask_)
+        {
+            size_t home = homeOf(table_[j].key, mask_);
+            // home 不在 (hole, j] 区间内的条目可以前移到 hole
+            bool movable = hole <= j ? (home <= hole || home > j) : (home <= hole && home > j);
+            if (!movable) continue;
+
+            table_[hole].key = std::move(table_[j].key);
+            table_[hole].value = std::move(table_[j].value);
+            table_[hole].meta.store(table_[j].meta.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            hole = j;
+        }
+        table_[hole].key = Key{};
+        table_[hole].value = Value{};
+        table_[hole].meta.store(0, std::memory_order_relaxed);
+        --size_;
+    }
+
+private:
+    size_t capacity_;
+    SampledPolicy policy_;
+    size_t samples_;
+    size_t poolSize_;
+    size_t mask_;
+    size_t decayPeriod_;
+    Table table_;
+    size_t size_;
+    std::atomic<uint64_t> clock_;  // 写入次数，持独占锁递增，读者只读
+    std::minstd_rand rng_;         // 采样用，持独占锁使用
+    std::vector<Candidate> pool_;  // 淘汰池，按分数升序
+    std::shared_mutex mutex_;
+};
+
+} // namespace CacheDemo
@@ -0,0 +1,297 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include "Cachepolicy.h"
+#include "HashUtil.h"
+
+namespace CacheDemo
+{
+
+// 一个 64 字节桶能放下的路数：桶头 16 字节，其余放 key 和 value，最多 8 路
+template<typename Key, typename Value>
+constexpr size_t defaultWays()
+{
+    return std::max<size_t>(1, std::min<size_t>(8, (64 - 16) / (sizeof(Key) + sizeof(Value))));
+}
+
+// 组相联缓存：只适用于可平凡复制的小 key/value（如整数 key）。
+// key 哈希到唯一的桶，桶按缓存行对齐，内联存放各路的 tag、key、value，替换只在桶内进行（CLOCK），
+// 一次查找只访问一个缓存行；8 个 tag 字节作为一个 64 位字一次比较（SWAR），再只比对 tag 相同的 key。
+// 每个桶一个序列锁：读不加锁，读完校验序列号，期间有写入就重读；写入把序列号置为奇数独占该桶
+template<typename Key, typename Value, size_t Ways = defaultWays<Key, Value>()>
+class SetAssociativeCache : public Cachepolicy<Key, Value>
+{
+    static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<Value>::value,
+                  "SetAssociativeCache 要求 key 和 value 可平凡复制");
+    static_assert(Ways >= 1 && Ways <= 8, "每个桶最多 8 路");
+
+private:
+    struct alignas(64) Bucket
+    {
+        std::atomic<uint32_t> seq{0};     // 奇数表示正在写入
+        std::atomic<uint8_t> refBits{0};  // CLOCK 引用位，读者命中时置位，不受序列锁保护
+        uint8_t hand = 0;                 // CLOCK 指针，持写锁访问
+        uint8_t tags[8] = {};             // 0 表示空槽，凑满 8 字节便于整字比较
+        Key keys[Ways];
+        Value values[Ways];
+    };
+
+public:
+    using ComputeFn = typename Cachepolicy<Key, Value>::ComputeFn;
+    using UpdateFn = typename Cachepolicy<Key, Value>::UpdateFn;
+
+    // 桶数向上取整为 2 的幂，实际容量为桶数 * Ways
+    explicit SetAssociativeCache(size_t capacity)
+        : mask_(roundUpPow2((std::max<size_t>(1, capacity) + Ways - 1) / Ways) - 1),
+          buckets_(new Bucket[mask_ + 1]),
+          size_(0)
+    {}
+
+    SetAssociativeCache(const SetAssociativeCache&) = delete;
+    SetAssociativeCache& operator=(const SetAssociativeCache&) = delete;
+
+    void put(const Key& key, const Value& value) override
+    {
+        uint64_t hash = mixHash(std::hash<Key>()(key));
+        Bucket& bucket = bucketOf(hash);
+        uint32_t seq = lockBucket(bucket);
+        storeLocked(bucket, tagOf(hash), key, value);
+        unlockBucket(bucket, seq);
+    }
+
+    // 乐观读：不加锁，读完校验序列号
+    bool get(const Key& key, Value& value) override
+    {
+        uint64_t hash = mixHash(std::hash<Key>()(key));
+        Bucket& bucket = bucketOf(hash);
+        uint8_t tag = tagOf(hash);
+        while (true)
+        {
+            uint32_t before = bucket.seq.load(std::memory_order_acquire);
+            if (before & 1)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            size_t way = findWay(bucket, tag, key);
+            if (way != Ways) std::memcpy(&value, &bucket.values[way], sizeof(Value));
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (bucket.seq.load(std::memory_order_relaxed) != before) continue;
+
+            if (way == Ways) return false;
+            reference(bucket, way);
+            return true;
+        }
+    }
+
+    Value get(const Key& key)
+    {
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    // 以下读-改-写操作持桶写锁一次完成，fn 在锁内执行，不能再访问本缓存
+    Value compute(const Key& key, const ComputeFn& fn) override
+    {
+        uint64_t hash = mixHash(std::hash<Key>()(key));
+        Bucket& bucket = bucketOf(hash);
+        uint8_t tag = tagOf(hash);
+        uint32_t seq = lockBucket(bucket);
+        size_t way = findWay(bucket, tag, key);
+        Value value = fn(way != Ways ? &bucket.values[way] : nullptr);
+        storeLocked(bucket, tag, key, value);
+        unlockBucket(bucket, seq);
+        return value;
+    }
+
+    bool computeIfPresent(const Key& key, const UpdateFn& fn) override
+    {
+        uint64_t hash = mixHash(std::hash<Key>()(key));
+        Bucket& bucket = bucketOf(hash);
+        uint32_t seq = lockBucket(bucket);
+        size_t way = findWay(bucket, tagOf(hash), key);
+        if (way != Ways)
+        {
+            bucket.values[way] = fn(bucket.values[way]);
+            reference(bucket, way);
+        }
+        unlockBucket(bucket, seq);
+        return way != Ways;
+    }
+
+    bool putIfAbsent(const Key& key, const Value& value) override
+    {
+        uint64_t hash = mixHash(std::hash<Key>()(key));
+        Bucket& bucket = bucketOf(hash);
+        uint8_t tag = tagOf(hash);
+        uint32_t seq = lockBucket(bucket);
+        bool absent = findWay(bucket, tag, key) == Ways;
+        if (absent) storeLocked(bucket, tag, key, value);
+        unlockBucket(bucket, seq);
+        return absent;
+    }
+
+    bool compareAndSet(const Key& key, const Value& expected, const Value& desired) override
+    {
+        uint64_t hash = mixHash(std::hash<Key>()(key));
+        Bucket& bucket = bucketOf(hash);
+        uint32_t seq = lockBucket(bucket);
+        size_t way = findWay(bucket, tagOf(hash), key);
+        bool swapped = way != Ways && bucket.values[way] == expected;
+        if (swapped)
+        {
+            bucket.values[way] = desired;
+            reference(bucket, way);
+        }
+        unlockBucket(bucket, seq);
+        return swapped;
+    }
+
+    // 逐个桶加锁清空，每个桶只短暂持锁
+    void clear() override
+    {
+        for (size_t b = 0; b <= mask_; ++b)
+        {
+            Bucket& bucket = buckets_[b];
+            uint32_t seq = lockBucket(bucket);
+            size_t used = 0;
+            for (size_t way = 0; way < Ways; ++way)
+            {
+                if (bucket.tags[way] != 0) ++used;
+                bucket.tags[way] = 0;
+            }
+            bucket.refBits.store(0, std::memory_order_relaxed);
+            unlockBucket(bucket, seq);
+            size_.fetch_sub(used, std::memory_order_relaxed);
+        }
+    }
+
+    size_t capacity() const { return (mask_ + 1) * Ways; }
+
+    // 近似条目数，并发时仅供参考
+    size_t size() const { return size_.load(std::memory_order_relaxed); }
+
+    static constexpr size_t ways() { return Ways; }
+    static constexpr size_t bucketBytes() { return sizeof(Bucket); }
+
+private:
+    // 打散后的哈希低位选桶，最高字节作 tag
+    static uint8_t tagOf(uint64_t hash)
+    {
+        uint8_t tag = static_cast<uint8_t>(hash >> 56);
+        return tag != 0 ? tag : 1;
+    }
+
+    Bucket& bucketOf(uint64_t hash) { return buckets_[hash & mask_]; }
+
+    // 8 个 tag 字节与目标 tag 整字异或，再用“含零字节”位运算找出相等的字节；
+    // 借位可能让真正匹配之上的字节误报（包括 tag 为 0 的空位，其中残留着清空前的 key），
+    // 所以先核对 tag 字节本身再比较 key。返回 Ways 表示不存在
+    static size_t findWay(const Bucket& bucket, uint8_t tag, const Key& key)
+    {
+        constexpr uint64_t LOW = 0x0101010101010101ULL;
+        constexpr uint64_t HIGH = 0x8080808080808080ULL;
+        uint64_t word;
+        std::memcpy(&word, bucket.tags, sizeof(word));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        word = __builtin_bswap64(word);  // 统一为 tags[0] 在最低字节
+#endif
+        uint64_t diff = word ^ (LOW * tag);
+        uint64_t matches = (diff - LOW) & ~diff & HIGH;
+        while (matches != 0)
+        {
+            size_t way = __builtin_ctzll(matches) / 8;
+            if (way >= Ways) break;
+            if (bucket.tags[way] == tag && bucket.keys[way] == key) return way;
+            matches &= matches - 1;
+        }
+        return Ways;
+    }
+
+    static void reference(Bucket& bucket, size_t way)
+    {
+        uint8_t bit = static_cast<uint8_t>(1u << way);
+        // 已置位时不再写，避免热点桶的缓存行在读者之间来回失效
+        if (!(bucket.refBits.load(std::memory_order_relaxed) & bit))
+        {
+            bucket.refBits.fetch_or(bit, std::memory_order_relaxed);
+        }
+    }
+
+    static uint32_t lockBucket(Bucket& bucket)
+    {
+        uint32_t seq = bucket.seq.load(std::memory_order_relaxed);
+        while ((seq & 1) || !bucket.seq.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire))
+        {
+            std::this_thread::yield();
+            seq = bucket.seq.load(std::memory_order_relaxed);
+        }
+        // 序列号先于数据写入对读者可见
+        std::atomic_thread_fence(std::memory_order_release);
+        return seq;
+    }
+
+    static void unlockBucket(Bucket& bucket, uint32_t seq)
+    {
+        bucket.seq.store(seq + 2, std::memory_order_release);
+    }
+
+    // 已存在则覆盖，否则放入空槽，桶满时按 CLOCK 替换（需持桶写锁调用）
+    void storeLocked(Bucket& bucket, uint8_t tag, const Key& key, const Value& value)
+    {
+        size_t way = findWay(bucket, tag, key);
+        if (way == Ways)
+        {
+            way = victimOf(bucket);
+            bucket.tags[way] = tag;
+            bucket.keys[way] = key;
+            // 新条目不置引用位，只访问一次的 key 会先被替换
+            bucket.refBits.fetch_and(static_cast<uint8_t>(~(1u << way)), std::memory_order_relaxed);
+        }
+        else
+        {
+            reference(bucket, way);
+        }
+        bucket.values[way] = value;
+    }
+
+    // 有空槽用空槽，否则从指针处开始清除引用位，取第一个未被引用的槽
+    size_t victimOf(Bucket& bucket)
+    {
+        for (size_t way = 0; way < Ways; ++way)
+        {
+            if (bucket.tags[way] == 0)
+            {
+                size_.fetch_add(1, std::memory_order_relaxed);
+                return way;
+            }
+        }
+        while (true)
+        {
+            size_t way = bucket.hand;
+            bucket.hand = static_cast<uint8_t>((way + 1) % Ways);
+            uint8_t bit = static_cast<uint8_t>(1u << way);
+            if (!(bucket.refBits.fetch_and(static_cast<uint8_t>(~bit), std::memory_order_relaxed) & bit))
+            {
+                return way;
+            }
+        }
+    }
+
+private:
+    size_t mask_;
+    std::unique_ptr<Bucket[]> buckets_;
+    std::atomic<size_t> size_;
+};
+
+} // namespace CacheDemo
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "Cachepolicy.h"
+
+namespace CacheDemo
+{
+
+// 通用分片包装：按 key 的哈希把请求分到 sliceNum 个独立加锁的 Policy 实例上，
+// 与 HashLRUCache 的分片方式相同，可用于任何构造函数以容量为第一个参数的 Cachepolicy
+template<typename Key, typename Value, typename Policy>
+class ShardedCache : public Cachepolicy<Key, Value>
+{
+public:
+    using ComputeFn = typename Cachepolicy<Key, Value>::ComputeFn;
+    using UpdateFn = typename Cachepolicy<Key, Value>::UpdateFn;
+
+    // sliceNum <= 0 时按硬件线程数分片；args 原样传给每个分片容量之后的构造参数
+    template<typename... Args>
+    ShardedCache(size_t capacity, int sliceNum, const Args&... args)
+        : capacity_(capacity),
+          sliceNum_(sliceNum > 0 ? sliceNum : std::thread::hardware_concurrency())
+    {
+        size_t sliceSize = std::ceil(capacity / static_cast<double>(sliceNum_));
+        for (int i = 0; i < sliceNum_; ++i)
+        {
+            slices_.emplace_back(std::make_unique<Policy>(sliceSize, args...));
+        }
+    }
+
+    void put(const Key& key, const Value& value) override
+    {
+        sliceOf(key).put(key, value);
+    }
+
+    bool get(const Key& key, Value& value) override
+    {
+        return sliceOf(key).get(key, value);
+    }
+
+    Value get(const Key& key)
+    {
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    // 读-改-写操作转发给 key 所在分片，在分片锁内一次完成
+    Value compute(const Key& key, const ComputeFn& fn) override
+    {
+        return sliceOf(key).compute(key, fn);
+    }
+
+    bool computeIfPresent(const Key& key, const UpdateFn& fn) override
+    {
+        return sliceOf(key).computeIfPresent(key, fn);
+    }
+
+    bool putIfAbsent(const Key& key, const Value& value) override
+    {
+        return sliceOf(key).putIfAbsent(key, value);
+    }
+
+    bool compareAndSet(const Key& key, const Value& expected, const Value& desired) override
+    {
+        return sliceOf(key).compareAndSet(key, expected, desired);
+    }
+
+    // 逐个分片清空
+    void clear() override
+    {
+        for (auto& slice : slices_)
+        {
+            slice->clear();
+        }
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    // 要求 Policy 提供 size()
+    size_t size()
+    {
+        size_t total = 0;
+        for (auto& slice : slices_)
+        {
+            total += slice->size();
+        }
+        return total;
+    }
+
+    int sliceNum() const { return sliceNum_; }
+    Policy& slice(int i) { return *slices_[i]; }
+
+private:
+    Policy& sliceOf(const Key& key)
+    {
+        return *slices_[std::hash<Key>()(key) % sliceNum_];
+    }
+
+private:
+    size_t capacity_;
+    int sliceNum_;
+    std::vector<std::unique_ptr<Policy>> slices_;
+};
+
+} // namespace CacheDemo
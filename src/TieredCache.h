@@ -0,0 +1,585 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Cachepolicy.h"
+#include "LRUCache.h"
+
+namespace CacheDemo
+{
+
+// 磁盘层的序列化方式，默认支持可平凡拷贝类型和 std::string
+// 其他类型可自行特化 DiskCodec
+template<typename T, typename Enable = void>
+struct DiskCodec;
+
+template<typename T>
+struct DiskCodec<T, std::enable_if_t<std::is_trivially_copyable<T>::value>>
+{
+    static void encode(const T& v, std::string& out)
+    {
+        out.append(reinterpret_cast<const char*>(&v), sizeof(T));
+    }
+
+    static bool decode(const char* data, size_t len, T& v)
+    {
+        if (len != sizeof(T)) return false;
+        std::memcpy(&v, data, sizeof(T));
+        return true;
+    }
+};
+
+template<>
+struct DiskCodec<std::string>
+{
+    static void encode(const std::string& v, std::string& out)
+    {
+        out.append(v);
+    }
+
+    static bool decode(const char* data, size_t len, std::string& v)
+    {
+        v.assign(data, len);
+        return true;
+    }
+};
+
+// 日志结构的磁盘层：
+// 数据只追加写入当前段文件，内存中只保留 key->(段号,偏移,长度) 的紧凑索引，
+// 段数超过上限时按 FIFO 整段回收最老的段文件。
+// 写入分两步：append 只追加字节并返回位置，commit 才让索引指向它，
+// 上层可以在自己的锁外做磁盘写，再在锁内决定这次写入是否还有效。
+// 读写都只在锁内查索引、预留偏移，pread/pwrite 在锁外进行；段文件由引用计数管理，
+// 被回收的段等最后一个读写者结束才关闭。每个实例在 dir 下建独立子目录，多个实例可共用 dir
+template<typename Key, typename Value>
+class DiskTier
+{
+public:
+    // 索引项，每个 key 占 16 字节；偏移用 64 位，段文件可以超过 4 GiB
+    struct Location
+    {
+        uint64_t offset;
+        uint32_t segId;
+        uint32_t length;
+    };
+
+private:
+    // 记录头：key长度 + value长度，后面紧跟 key 和 value 的字节
+    struct RecordHeader
+    {
+        uint32_t keyLen;
+        uint32_t valueLen;
+    };
+
+    // 最后一个引用释放时关闭并删除文件
+    struct SegmentFile
+    {
+        int fd;
+        std::string path;
+
+        SegmentFile(int f, std::string p) : fd(f), path(std::move(p)) {}
+        ~SegmentFile()
+        {
+            ::close(fd);
+            ::unlink(path.c_str());
+        }
+        SegmentFile(const SegmentFile&) = delete;
+        SegmentFile& operator=(const SegmentFile&) = delete;
+    };
+
+    struct Segment
+    {
+        uint32_t id;
+        std::shared_ptr<SegmentFile> file;
+        std::vector<Key> keys;  // 提交到本段的 key，回收时只清理这些索引项
+    };
+
+public:
+    // 锁内查到的记录位置，连同段文件引用一起带到锁外读取
+    struct ReadRef
+    {
+        Location loc;
+        std::shared_ptr<SegmentFile> file;
+    };
+
+    DiskTier(const std::string& dir, size_t segmentBytes, size_t maxSegments)
+        : segmentBytes_(segmentBytes),
+          maxSegments_(maxSegments > 0 ? maxSegments : 1),
+          nextSegId_(0),
+          writeOffset_(0)
+    {
+        // 目录已存在不算错误，打开失败时磁盘层退化为不可用（淘汰数据直接丢弃）
+        ::mkdir(dir.c_str(), 0755);
+        std::string pattern = dir + "/tier_XXXXXX";
+        if (::mkdtemp(&pattern[0]) == nullptr) return;
+        dir_ = pattern;
+        openSegment();
+    }
+
+    ~DiskTier()
+    {
+        segments_.clear();
+        if (!dir_.empty()) ::rmdir(dir_.c_str());
+    }
+
+    DiskTier(const DiskTier&) = delete;
+    DiskTier& operator=(const DiskTier&) = delete;
+
+    bool ok() const { return !segments_.empty(); }
+
+    // 追加写入一条记录，同 key 的旧记录自动失效
+    void put(const Key& key, const Value& value)
+    {
+        Location loc;
+        if (append(key, value, loc)) commit(key, loc);
+    }
+
+    // 只把记录追加到当前段，不修改索引；锁内只预留偏移，写盘在锁外。
+    // 单条记录超过 4 GiB 时拒绝写入
+    bool append(const Key& key, const Value& value, Location& loc)
+    {
+        std::string record;
+        encodeRecord(key, value, record);
+        if (record.size() > std::numeric_limits<uint32_t>::max()) return false;
+
+        std::shared_ptr<SegmentFile> file;
+        {
+            std::lock_guard<std::mutex> lock(diskmutex_);
+            if (segments_.empty()) return false;
+
+            if (writeOffset_ > 0 && writeOffset_ + record.size() > segmentBytes_)
+            {
+                if (!openSegment()) return false;
+            }
+
+            Segment& seg = segments_.back();
+            file = seg.file;
+            loc = Location{writeOffset_, seg.id, static_cast<uint32_t>(record.size())};
+            writeOffset_ += record.size();
+        }
+        // 写失败只留下一段空洞，没有提交就不会被读到
+        return writeAll(file->fd, record.data(), record.size(), loc.offset);
+    }
+
+    // 让索引指向 append 写下的记录；所在段期间已被回收则丢弃
+    void commit(const Key& key, const Location& loc)
+    {
+        std::lock_guard<std::mutex> lock(diskmutex_);
+        Segment* seg = findSegment(loc.segId);
+        if (seg == nullptr) return;
+        index_[key] = loc;
+        seg->keys.push_back(key);
+    }
+
+    // 只在锁内查索引，返回的引用可在锁外交给 read
+    bool locate(const Key& key, ReadRef& ref)
+    {
+        std::lock_guard<std::mutex> lock(diskmutex_);
+        auto it = index_.find(key);
+        if (it == index_.end()) return false;
+        Segment* seg = findSegment(it->second.segId);
+        if (seg == nullptr) return false;
+        ref.loc = it->second;
+        ref.file = seg->file;
+        return true;
+    }
+
+    // 不加锁，段被回收后文件仍保持打开直到引用释放
+    static bool read(const Key& key, const ReadRef& ref, Value& value)
+    {
+        return readRecord(key, ref.file->fd, ref.loc, value);
+    }
+
+    bool get(const Key& key, Value& value)
+    {
+        ReadRef ref;
+        return locate(key, ref) && read(key, ref, value);
+    }
+
+    // 索引仍指向 loc 时摘除并返回 true，用于锁外读完后确认回填的是最新记录
+    bool eraseIf(const Key& key, const Location& loc)
+    {
+        std::lock_guard<std::mutex> lock(diskmutex_);
+        auto it = index_.find(key);
+        if (it == index_.end() || it->second.segId != loc.segId || it->second.offset != loc.offset)
+        {
+            return false;
+        }
+        index_.erase(it);
+        return true;
+    }
+
+    void erase(const Key& key)
+    {
+        std::lock_guard<std::mutex> lock(diskmutex_);
+        index_.erase(key);
+    }
+
+    size_t size()
+    {
+        std::lock_guard<std::mutex> lock(diskmutex_);
+        return index_.size();
+    }
+
+    // 整段丢弃：持锁换出索引和全部段并开一个新段，旧段文件在锁外关闭删除
+    void clear()
+    {
+        std::deque<Segment> segments;
+        std::unordered_map<Key, Location> index;
+        {
+            std::lock_guard<std::mutex> lock(diskmutex_);
+            if (dir_.empty()) return;
+            segments.swap(segments_);
+            index.swap(index_);
+            openSegment();
+        }
+    }
+
+private:
+    static void encodeRecord(const Key& key, const Value& value, std::string& record)
+    {
+        std::string keyBytes;
+        std::string valueBytes;
+        DiskCodec<Key>::encode(key, keyBytes);
+        DiskCodec<Value>::encode(value, valueBytes);
+
+        RecordHeader header{static_cast<uint32_t>(keyBytes.size()),
+                            static_cast<uint32_t>(valueBytes.size())};
+        record.reserve(sizeof(header) + keyBytes.size() + valueBytes.size());
+        record.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        record.append(keyBytes);
+        record.append(valueBytes);
+    }
+
+    static bool readRecord(const Key& key, int fd, const Location& loc, Value& value)
+    {
+        std::string buf(loc.length, '\0');
+        ssize_t n = ::pread(fd, &buf[0], loc.length, loc.offset);
+        if (n != static_cast<ssize_t>(loc.length) || n < static_cast<ssize_t>(sizeof(RecordHeader)))
+        {
+            return false;
+        }
+
+        RecordHeader header;
+        std::memcpy(&header, buf.data(), sizeof(header));
+        if (sizeof(header) + header.keyLen + header.valueLen != loc.length) return false;
+
+        // 校验 key，防止读到错位的数据
+        Key stored;
+        if (!DiskCodec<Key>::decode(buf.data() + sizeof(header), header.keyLen, stored) || !(stored == key))
+        {
+            return false;
+        }
+        return DiskCodec<Value>::decode(buf.data() + sizeof(header) + header.keyLen, header.valueLen, value);
+    }
+
+    static bool writeAll(int fd, const char* data, size_t len, uint64_t offset)
+    {
+        while (len > 0)
+        {
+            ssize_t n = ::pwrite(fd, data, len, offset);
+            if (n <= 0) return false;
+            data += n;
+            len -= n;
+            offset += n;
+        }
+        return true;
+    }
+
+    Segment* findSegment(uint32_t id)
+    {
+        if (segments_.empty() || id < segments_.front().id) return nullptr;
+        size_t pos = id - segments_.front().id;
+        return pos < segments_.size() ? &segments_[pos] : nullptr;
+    }
+
+    // 子目录为本实例独占，O_TRUNC 只会截断自己回收过的旧段
+    bool openSegment()
+    {
+        std::string path = dir_ + "/seg_" + std::to_string(nextSegId_) + ".log";
+        int fd = ::open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+        if (fd < 0) return false;
+
+        Segment seg;
+        seg.id = nextSegId_++;
+        seg.file = std::make_shared<SegmentFile>(fd, std::move(path));
+        segments_.push_back(std::move(seg));
+        writeOffset_ = 0;
+
+        while (segments_.size() > maxSegments_)
+        {
+            reclaimOldest();
+        }
+        return true;
+    }
+
+    // FIFO 回收：整段删除最老的段，只检查提交到该段的 key，仍指向它的索引项才清理；
+    // 文件在最后一个锁外读写结束后才关闭
+    void reclaimOldest()
+    {
+        Segment& oldest = segments_.front();
+        for (auto& key : oldest.keys)
+        {
+            auto it = index_.find(key);
+            if (it != index_.end() && it->second.segId == oldest.id)
+            {
+                index_.erase(it);
+            }
+        }
+        segments_.pop_front();
+    }
+
+private:
+    std::string dir_;       // 本实例独占的子目录，创建失败时为空
+    size_t segmentBytes_;   // 单个段文件的大小上限
+    size_t maxSegments_;    // 最多保留的段数
+    uint32_t nextSegId_;
+    uint64_t writeOffset_;  // 当前段的追加位置
+    std::deque<Segment> segments_;
+    std::unordered_map<Key, Location> index_;
+    std::mutex diskmutex_;
+};
+
+// 内存 + 本地磁盘两级缓存：
+// 内存层 LRU 淘汰的数据不再直接丢弃，而是溢出到磁盘层，
+// 内存未命中时再查磁盘，命中则回填内存层。
+// 分层锁只保护内存层、待写盘表和磁盘索引的一致性，溢出的磁盘写在锁外进行：
+// 被挤出的条目先登记到 spilling_ 仍可读到，写盘后再回到锁内提交索引，
+// 期间该 key 被重新写入或再次淘汰时这次写盘作废，不会用旧值覆盖新值
+template<typename Key, typename Value>
+class TieredLRUCache : public Cachepolicy<Key, Value>
+{
+private:
+    using Location = typename DiskTier<Key, Value>::Location;
+
+    struct Pending
+    {
+        Value value;
+        uint64_t seq;
+    };
+
+    // 离开分层锁后要写盘的条目
+    struct Spill
+    {
+        Key key;
+        Value value;
+        uint64_t seq = 0;
+        bool valid = false;
+    };
+
+public:
+    using ComputeFn = typename Cachepolicy<Key, Value>::ComputeFn;
+    using UpdateFn = typename Cachepolicy<Key, Value>::UpdateFn;
+
+    TieredLRUCache(size_t memCapacity, const std::string& dir,
+                   size_t segmentBytes = 64 * 1024 * 1024, size_t maxSegments = 16)
+        : memTier_(memCapacity),
+          diskTier_(dir, segmentBytes, maxSegments),
+          spillSeq_(0)
+    {}
+
+    ~TieredLRUCache() override = default;
+
+    void put(const Key& key, const Value& value) override
+    {
+        Spill spill;
+        {
+            std::lock_guard<std::mutex> lock(tiermutex_);
+            writeLocked(key, value, spill);
+        }
+        spillToDisk(spill);
+    }
+
+    bool get(const Key& key, Value& value) override
+    {
+        // 内存命中不需要经过分层锁
+        if (memTier_.get(key, value)) return true;
+
+        // 磁盘读在分层锁外：锁内查位置，出锁 pread，再回到锁内确认索引仍指向这条记录才回填；
+        // 期间 key 被改写或另一次淘汰提交了新记录就重查
+        while (true)
+        {
+            typename DiskTier<Key, Value>::ReadRef ref;
+            Spill spill;
+            {
+                std::lock_guard<std::mutex> lock(tiermutex_);
+                // 加锁期间可能已被其他线程回填
+                if (memTier_.get(key, value)) return true;
+
+                auto it = spilling_.find(key);
+                if (it != spilling_.end())
+                {
+                    value = it->second.value;
+                    spilling_.erase(it);
+                    putToMemory(key, value, spill);
+                }
+                else if (!diskTier_.locate(key, ref))
+                {
+                    return false;
+                }
+            }
+            if (ref.file == nullptr)
+            {
+                spillToDisk(spill);
+                return true;
+            }
+
+            Value loaded;
+            bool readOk = DiskTier<Key, Value>::read(key, ref, loaded);
+            {
+                std::lock_guard<std::mutex> lock(tiermutex_);
+                if (!diskTier_.eraseIf(key, ref.loc)) continue;
+                if (!readOk) return false;
+                value = std::move(loaded);
+                putToMemory(key, value, spill);
+            }
+            spillToDisk(spill);
+            return true;
+        }
+    }
+
+    Value get(const Key& key)
+    {
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    // 以下读-改-写操作在分层锁内完成，旧值依次查内存层、待写盘表和磁盘层，
+    // 写入与 put 相同（新值进内存层，磁盘上的旧记录作废）；fn 在锁内执行，不能再访问本缓存
+    Value compute(const Key& key, const ComputeFn& fn) override
+    {
+        Spill spill;
+        Value value;
+        {
+            std::lock_guard<std::mutex> lock(tiermutex_);
+            Value old;
+            value = fn(lookupLocked(key, old) ? &old : nullptr);
+            writeLocked(key, value, spill);
+        }
+        spillToDisk(spill);
+        return value;
+    }
+
+    bool computeIfPresent(const Key& key, const UpdateFn& fn) override
+    {
+        Spill spill;
+        {
+            std::lock_guard<std::mutex> lock(tiermutex_);
+            Value old;
+            if (!lookupLocked(key, old)) return false;
+            writeLocked(key, fn(old), spill);
+        }
+        spillToDisk(spill);
+        return true;
+    }
+
+    bool putIfAbsent(const Key& key, const Value& value) override
+    {
+        Spill spill;
+        {
+            std::lock_guard<std::mutex> lock(tiermutex_);
+            Value old;
+            if (lookupLocked(key, old)) return false;
+            writeLocked(key, value, spill);
+        }
+        spillToDisk(spill);
+        return true;
+    }
+
+    bool compareAndSet(const Key& key, const Value& expected, const Value& desired) override
+    {
+        Spill spill;
+        {
+            std::lock_guard<std::mutex> lock(tiermutex_);
+            Value old;
+            if (!lookupLocked(key, old) || !(old == expected)) return false;
+            writeLocked(key, desired, spill);
+        }
+        spillToDisk(spill);
+        return true;
+    }
+
+    size_t diskSize() { return diskTier_.size(); }
+
+    // 尚在写盘途中的条目随 spilling_ 一起清掉，它们回到锁内时发现已不在表中，写盘作废
+    void clear() override
+    {
+        std::lock_guard<std::mutex> lock(tiermutex_);
+        memTier_.clear();
+        spilling_.clear();
+        diskTier_.clear();
+    }
+
+private:
+    // 只读取不调整顺序，内存层没有时读待写盘表和磁盘层但不回填（需持 tiermutex_）
+    bool lookupLocked(const Key& key, Value& value)
+    {
+        if (memTier_.peek(key, value)) return true;
+        auto it = spilling_.find(key);
+        if (it != spilling_.end())
+        {
+            value = it->second.value;
+            return true;
+        }
+        return diskTier_.get(key, value);
+    }
+
+    // 新值进内存层，其他层的旧值作废（需持 tiermutex_）
+    void writeLocked(const Key& key, const Value& value, Spill& spill)
+    {
+        diskTier_.erase(key);
+        spilling_.erase(key);
+        putToMemory(key, value, spill);
+    }
+
+    // 被挤出内存层的条目登记到 spilling_，由调用方出锁后写盘（需持 tiermutex_）
+    void putToMemory(const Key& key, const Value& value, Spill& spill)
+    {
+        typename LRUCache<Key, Value>::Nodetype evicted;
+        if (!memTier_.putAndEvict(key, value, evicted)) return;
+
+        spill.seq = ++spillSeq_;
+        spilling_[evicted.first] = Pending{evicted.second, spill.seq};
+        spill.key = std::move(evicted.first);
+        spill.value = std::move(evicted.second);
+        spill.valid = true;
+    }
+
+    // 锁外追加写盘，回到锁内确认 spilling_ 中还是这一次淘汰才提交索引
+    void spillToDisk(Spill& spill)
+    {
+        if (!spill.valid) return;
+
+        Location loc;
+        bool written = diskTier_.append(spill.key, spill.value, loc);
+
+        std::lock_guard<std::mutex> lock(tiermutex_);
+        auto it = spilling_.find(spill.key);
+        if (it == spilling_.end() || it->second.seq != spill.seq) return;
+        if (written) diskTier_.commit(spill.key, loc);
+        spilling_.erase(it);
+    }
+
+private:
+    LRUCache<Key, Value> memTier_;
+    DiskTier<Key, Value> diskTier_;
+    std::unordered_map<Key, Pending> spilling_;  // 已被内存层淘汰、尚未提交到磁盘索引的条目
+    uint64_t spillSeq_;
+    std::mutex tiermutex_;  // 保证跨层的 put/回填 不会互相覆盖
+};
+
+} // namespace CacheDemo
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "Cachepolicy.h"
+#include "HashUtil.h"
+#include "RemovalListener.h"
+
+namespace CacheDemo
+{
+
+// 两级缓存：每个线程一份无锁的直接映射 L1，后面是共享的 L2（任意 Cachepolicy）。
+// L1 条目记录写入时所在分条的版本号，L2 上的写入和失效只需把对应分条版本加一，
+// 各线程的 L1 在下次命中校验时自然作废，不需要遍历或通知其他线程。
+// 所有写入都必须经过本类（或在绕过本类写 L2 后调用 invalidate），否则 L1 可能读到旧值
+template<typename Key, typename Value>
+class TwoLevelCache : public Cachepolicy<Key, Value>
+{
+private:
+    static constexpr size_t VERSION_STRIPES = 64;
+    // 每个线程每多少次 L1 命中改读一次 L2，让 L2 看到热点的访问
+    static constexpr size_t L2_TOUCH_INTERVAL = 64;
+
+    struct alignas(64) VersionStripe
+    {
+        std::atomic<uint64_t> version{0};
+    };
+
+    struct Slot
+    {
+        Key key{};
+        Value value{};
+        uint64_t version = 0;
+        bool valid = false;
+    };
+
+    // 单个线程的 L1，只由所属线程读写；命中计数供其他线程汇总
+    struct L1Table
+    {
+        explicit L1Table(size_t size) : slots(size) {}
+
+        std::vector<Slot> slots;
+        std::atomic<size_t> hits{0};
+        size_t untouched = 0;  // 距上次读 L2 的 L1 命中次数
+    };
+
+    // 线程侧登记的 L1：alive 失效说明实例已销毁，table 不能再访问
+    struct LocalEntry
+    {
+        std::weak_ptr<void> alive;
+        L1Table* table;
+    };
+
+public:
+    using ComputeFn = typename Cachepolicy<Key, Value>::ComputeFn;
+    using UpdateFn = typename Cachepolicy<Key, Value>::UpdateFn;
+
+    // l1Size: 每个线程 L1 的槽位数，向上取整为 2 的幂
+    TwoLevelCache(std::unique_ptr<Cachepolicy<Key, Value>> l2, size_t l1Size = 256)
+        : l2_(std::move(l2)),
+          l1Mask_(roundUpPow2(l1Size > 0 ? l1Size : 1) - 1),
+          id_(nextId().fetch_add(1)),
+          alive_(std::make_shared<char>()),
+          versions_(new VersionStripe[VERSION_STRIPES])
+    {}
+
+    TwoLevelCache(const TwoLevelCache&) = delete;
+    TwoLevelCache& operator=(const TwoLevelCache&) = delete;
+
+    void put(const Key& key, const Value& value) override
+    {
+        size_t hash = std::hash<Key>()(key);
+        std::atomic<uint64_t>& version = versions_[stripeOf(hash)].version;
+        uint64_t before = version.load(std::memory_order_acquire);
+        l2_->put(key, value);
+        // 先写 L2 再升版本：读者若在升版本前读到版本号，它缓存的条目随即作废
+        uint64_t prev = version.fetch_add(1, std::memory_order_acq_rel);
+
+        // 期间没有其他写者升过版本，才能把新值放进本线程 L1，写后立即读仍能命中
+        Slot& slot = localTable().slots[hash & l1Mask_];
+        slot.valid = prev == before;
+        if (slot.valid)
+        {
+            slot.key = key;
+            slot.value = value;
+            slot.version = prev + 1;
+        }
+    }
+
+    bool get(const Key& key, Value& value) override
+    {
+        size_t hash = std::hash<Key>()(key);
+        L1Table& table = localTable();
+        Slot& slot = table.slots[hash & l1Mask_];
+        std::atomic<uint64_t>& version = versions_[stripeOf(hash)].version;
+
+        uint64_t current = version.load(std::memory_order_acquire);
+        // 命中 L1 时 L2 看不到这次访问，热点会在 L2 中变冷而被先淘汰；
+        // 因此每 L2_TOUCH_INTERVAL 次命中改走一次 L2，刷新它的访问顺序，同时重新校验 L1
+        if (slot.valid && slot.version == current && slot.key == key && ++table.untouched < L2_TOUCH_INTERVAL)
+        {
+            value = slot.value;
+            table.hits.store(table.hits.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return true;
+        }
+        table.untouched = 0;
+
+        // 版本号在读 L2 之前取，期间若有写入则该条目下次校验时失效
+        if (!l2_->get(key, value))
+        {
+            if (slot.key == key) slot.valid = false;
+            return false;
+        }
+        slot.key = key;
+        slot.value = value;
+        slot.version = current;
+        slot.valid = true;
+        return true;
+    }
+
+    Value get(const Key& key)
+    {
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    // 以下读-改-写操作交给 L2 原子完成，写入后升版本使所有线程的 L1 副本失效
+    Value compute(const Key& key, const ComputeFn& fn) override
+    {
+        Value value = l2_->compute(key, fn);
+        invalidate(key);
+        return value;
+    }
+
+    bool computeIfPresent(const Key& key, const UpdateFn& fn) override
+    {
+        if (!l2_->computeIfPresent(key, fn)) return false;
+        invalidate(key);
+        return true;
+    }
+
+    bool putIfAbsent(const Key& key, const Value& value) override
+    {
+        if (!l2_->putIfAbsent(key, value)) return false;
+        invalidate(key);
+        return true;
+    }
+
+    bool compareAndSet(const Key& key, const Value& expected, const Value& desired) override
+    {
+        if (!l2_->compareAndSet(key, expected, desired)) return false;
+        invalidate(key);
+        return true;
+    }
+
+    // 清空 L2 后使所有线程的 L1 失效
+    void clear() override
+    {
+        l2_->clear();
+        invalidateAll();
+    }
+
+    // 使所有线程 L1 中该 key（及同分条的 key）的副本失效
+    void invalidate(const Key& key)
+    {
+        bump(std::hash<Key>()(key));
+    }
+
+    void invalidateAll()
+    {
+        for (size_t i = 0; i < VERSION_STRIPES; ++i)
+        {
+            versions_[i].version.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    // 可直接作为 L2 的 RemovalDispatcher 监听器，淘汰、删除、覆盖都会使 L1 副本失效
+    void onRemoval(const std::vector<RemovalNotification<Key, Value>>& batch)
+    {
+        for (auto& notification : batch)
+        {
+            invalidate(notification.key);
+        }
+    }
+
+    // 各线程 L1 命中次数之和
+    size_t l1Hits()
+    {
+        std::lock_guard<std::mutex> lock(tablesMutex_);
+        size_t total = 0;
+        for (auto& table : tables_)
+        {
+            total += table->hits.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    Cachepolicy<Key, Value>& l2() { return *l2_; }
+
+private:
+    static std::atomic<uint64_t>& nextId()
+    {
+        static std::atomic<uint64_t> id(0);
+        return id;
+    }
+
+    // 槽位用哈希低位，分条用高位，避免两者相关
+    static size_t stripeOf(size_t hash)
+    {
+        return (hash * 0x9E3779B97F4A7C15ULL) >> 58;
+    }
+
+    void bump(size_t hash)
+    {
+        versions_[stripeOf(hash)].version.fetch_add(1, std::memory_order_release);
+    }
+
+    // 取本线程在该实例上的 L1。表归实例所有，线程侧按实例 id 记指针并弱引用实例的存活标记；
+    // id 永不复用，实例销毁后残留的指针不会再被访问，并在下次登记新实例时清掉
+    L1Table& localTable()
+    {
+        thread_local uint64_t lastId = static_cast<uint64_t>(-1);
+        thread_local L1Table* lastTable = nullptr;
+        if (lastId == id_) return *lastTable;
+
+        thread_local std::unordered_map<uint64_t, LocalEntry> tables;
+        auto it = tables.find(id_);
+        if (it == tables.end())
+        {
+            for (auto entry = tables.begin(); entry != tables.end();)
+            {
+                entry = entry->second.alive.expired() ? tables.erase(entry) : std::next(entry);
+            }
+            std::lock_guard<std::mutex> lock(tablesMutex_);
+            tables_.emplace_back(new L1Table(l1Mask_ + 1));
+            it = tables.emplace(id_, LocalEntry{alive_, tables_.back().get()}).first;
+        }
+        lastId = id_;
+        lastTable = it->second.table;
+        return *lastTable;
+    }
+
+private:
+    std::unique_ptr<Cachepolicy<Key, Value>> l2_;
+    size_t l1Mask_;
+    uint64_t id_;
+    std::shared_ptr<void> alive_;  // 只用于让线程侧判断实例是否已销毁
+    std::unique_ptr<VersionStripe[]> versions_;
+    std::vector<std::unique_ptr<L1Table>> tables_;  // 所有线程的 L1，随实例一起释放
+    std::mutex tablesMutex_;
+};
+
+} // namespace CacheDemo
@@ -0,0 +1,254 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <unordered_map>
+#include "Cachepolicy.h"
+#include "IndexList.h"
+
+namespace CacheDemo
+{
+
+// 2Q（完整版）：新 key 进 A1in（FIFO，命中不调整顺序），A1in 超额时尾部被淘汰，
+// 只把 key 记入 A1out（ghost FIFO）；A1out 中的 key 再次写入时说明不是一次性访问，直接进 Am（LRU）。
+// 扫描数据只在 A1in 中流过，Am 中的热数据不受影响
+template<typename Key, typename Value>
+class TwoQCache : public Cachepolicy<Key, Value>
+{
+private:
+    enum class Queue : uint8_t { A1in, A1out, Am };
+
+    struct Node
+    {
+        Key key{};
+        Value value{};
+        Queue queue = Queue::A1in;
+        IndexLink link;
+    };
+
+    using QueueList = IndexList<Node, &Node::link>;
+
+public:
+    using ComputeFn = typename Cachepolicy<Key, Value>::ComputeFn;
+    using UpdateFn = typename Cachepolicy<Key, Value>::UpdateFn;
+    using Index = std::pmr::unordered_map<Key, uint32_t>;
+
+    // inRatio: A1in 占容量的比例；outRatio: A1out 最多记录的 key 数占容量的比例。
+    // 论文推荐 25% / 50%；resource 用于 key 索引
+    explicit TwoQCache(size_t capacity, double inRatio = 0.25, double outRatio = 0.5,
+                       std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : capacity_(capacity),
+          inCapacity_(std::max<size_t>(1, static_cast<size_t>(capacity * inRatio))),
+          outCapacity_(std::max<size_t>(1, static_cast<size_t>(capacity * outRatio))),
+          pool_(capacity + outCapacity_ + 1),
+          index_(resource),
+          residentCount_(0)
+    {
+        index_.reserve(pool_.size());
+    }
+
+    ~TwoQCache() override = default;
+
+    void put(const Key& key, const Value& value) override
+    {
+        if (capacity_ == 0) return;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t i = findResident(key);
+        if (i != NIL_INDEX)
+        {
+            pool_[i].value = value;
+            touch(i);
+            return;
+        }
+        insert(key, value);
+    }
+
+    bool get(const Key& key, Value& value) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t i = findResident(key);
+        if (i == NIL_INDEX) return false;
+
+        value = pool_[i].value;
+        touch(i);
+        return true;
+    }
+
+    Value get(const Key& key)
+    {
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    // 以下读-改-写操作一次加锁完成，fn 在锁内执行，不能再访问本缓存
+    Value compute(const Key& key, const ComputeFn& fn) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t i = findResident(key);
+        if (i != NIL_INDEX)
+        {
+            pool_[i].value = fn(&pool_[i].value);
+            touch(i);
+            return pool_[i].value;
+        }
+        Value value = fn(nullptr);
+        if (capacity_ > 0) insert(key, value);
+        return value;
+    }
+
+    bool computeIfPresent(const Key& key, const UpdateFn& fn) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t i = findResident(key);
+        if (i == NIL_INDEX) return false;
+
+        pool_[i].value = fn(pool_[i].value);
+        touch(i);
+        return true;
+    }
+
+    bool putIfAbsent(const Key& key, const Value& value) override
+    {
+        if (capacity_ == 0) return false;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (findResident(key) != NIL_INDEX) return false;
+        insert(key, value);
+        return true;
+    }
+
+    bool compareAndSet(const Key& key, const Value& expected, const Value& desired) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t i = findResident(key);
+        if (i == NIL_INDEX || !(pool_[i].value == expected)) return false;
+
+        pool_[i].value = desired;
+        touch(i);
+        return true;
+    }
+
+    // 新的节点池和索引在锁外准备好，持锁只做交换，旧数据在锁外释放
+    void clear() override
+    {
+        NodePool<Node> pool(pool_.size());
+        Index index(index_.get_allocator());
+        index.reserve(pool.size());
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pool.swap(pool_);
+            index.swap(index_);
+            a1in_ = QueueList();
+            a1out_ = QueueList();
+            am_ = QueueList();
+            residentCount_ = 0;
+        }
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    // 常驻（可命中）的条目数
+    size_t size()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return residentCount_;
+    }
+
+private:
+    uint32_t findResident(const Key& key)
+    {
+        auto it = index_.find(key);
+        if (it == index_.end() || pool_[it->second].queue == Queue::A1out) return NIL_INDEX;
+        return it->second;
+    }
+
+    // 命中：Am 中的移到头部，A1in 中的保持 FIFO 顺序不动（需持锁调用）
+    void touch(uint32_t i)
+    {
+        if (pool_[i].queue == Queue::Am)
+        {
+            am_.moveToFront(pool_.data(), i);
+        }
+    }
+
+    // 写入不常驻的 key：在 A1out 中的进 Am，否则进 A1in（需持锁调用）
+    void insert(const Key& key, const Value& value)
+    {
+        // 先腾位置再查索引：淘汰时可能移除最旧的 ghost，其中可能就有 key
+        if (residentCount_ >= capacity_) evict();
+
+        auto it = index_.find(key);
+        if (it != index_.end())
+        {
+            uint32_t i = it->second;
+            a1out_.unlink(pool_.data(), i);
+            pool_[i].value = value;
+            pool_[i].queue = Queue::Am;
+            am_.pushFront(pool_.data(), i);
+            ++residentCount_;
+            return;
+        }
+
+        uint32_t i = pool_.acquire();
+        Node& node = pool_[i];
+        node.key = key;
+        node.value = value;
+        node.queue = Queue::A1in;
+        a1in_.pushFront(pool_.data(), i);
+        index_.emplace(key, i);
+        ++residentCount_;
+    }
+
+    // A1in 超额时淘汰其尾部并记入 A1out，否则淘汰 Am 尾部（需持锁调用）
+    void evict()
+    {
+        if (a1in_.size > inCapacity_ || am_.empty())
+        {
+            uint32_t victim = a1in_.tail;
+            a1in_.unlink(pool_.data(), victim);
+            --residentCount_;
+            Node& node = pool_[victim];
+            node.value = Value{};
+            node.queue = Queue::A1out;
+            a1out_.pushFront(pool_.data(), victim);
+            if (a1out_.size > outCapacity_)
+            {
+                uint32_t oldest = a1out_.tail;
+                a1out_.unlink(pool_.data(), oldest);
+                release(oldest);
+            }
+            return;
+        }
+
+        uint32_t victim = am_.tail;
+        am_.unlink(pool_.data(), victim);
+        --residentCount_;
+        release(victim);
+    }
+
+    void release(uint32_t i)
+    {
+        Node& node = pool_[i];
+        index_.erase(node.key);
+        node.value = Value{};
+        pool_.release(i);
+    }
+
+private:
+    size_t capacity_;
+    size_t inCapacity_;
+    size_t outCapacity_;
+    NodePool<Node> pool_;  // 常驻 + A1out 上限 + 1 个，后续不再分配
+    Index index_;          // key -> 节点下标，包括 A1out 中的 key
+    QueueList a1in_;       // head 为最新进入
+    QueueList a1out_;      // head 为最新记录
+    QueueList am_;         // head 为最近访问
+    size_t residentCount_;
+    std::mutex mutex_;
+};
+
+} // namespace CacheDemo
@@ -0,0 +1,426 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fcntl.h>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Cachepolicy.h"
+#include "LRUCache.h"
+#include "TieredCache.h"
+
+namespace CacheDemo
+{
+
+// 写回目标（慢速后端存储）的抽象接口，一次写入一批合并后的数据
+template<typename Key, typename Value>
+class WriteSink
+{
+public:
+    virtual ~WriteSink() = default;
+
+    virtual void writeBatch(const std::vector<std::pair<Key, Value>>& batch) = 0;
+};
+
+// 内存中的后端替身，记录写入次数，便于测试写放大
+template<typename Key, typename Value>
+class MemorySink : public WriteSink<Key, Value>
+{
+public:
+    void writeBatch(const std::vector<std::pair<Key, Value>>& batch) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& kv : batch)
+        {
+            store_[kv.first] = kv.second;
+        }
+        writeCount_ += batch.size();
+        ++batchCount_;
+    }
+
+    bool get(const Key& key, Value& value)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = store_.find(key);
+        if (it == store_.end()) return false;
+        value = it->second;
+        return true;
+    }
+
+    size_t writeCount()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return writeCount_;
+    }
+
+    size_t batchCount()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return batchCount_;
+    }
+
+private:
+    std::unordered_map<Key, Value> store_;
+    size_t writeCount_ = 0;
+    size_t batchCount_ = 0;
+    std::mutex mutex_;
+};
+
+// 追加写本地文件的后端替身，记录格式与 DiskTier 相同（keyLen, valueLen, key, value）
+template<typename Key, typename Value>
+class FileSink : public WriteSink<Key, Value>
+{
+public:
+    explicit FileSink(const std::string& path)
+        : fd_(::open(path.c_str(), O_CREAT | O_APPEND | O_WRONLY, 0644))
+    {}
+
+    ~FileSink() override
+    {
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+    bool ok() const { return fd_ >= 0; }
+
+    void writeBatch(const std::vector<std::pair<Key, Value>>& batch) override
+    {
+        if (fd_ < 0) return;
+
+        // 整批编码后一次 write
+        std::string buf;
+        for (auto& kv : batch)
+        {
+            std::string keyBytes;
+            std::string valueBytes;
+            DiskCodec<Key>::encode(kv.first, keyBytes);
+            DiskCodec<Value>::encode(kv.second, valueBytes);
+            uint32_t lens[2] = {static_cast<uint32_t>(keyBytes.size()),
+                                static_cast<uint32_t>(valueBytes.size())};
+            buf.append(reinterpret_cast<const char*>(lens), sizeof(lens));
+            buf.append(keyBytes);
+            buf.append(valueBytes);
+        }
+
+        const char* data = buf.data();
+        size_t len = buf.size();
+        while (len > 0)
+        {
+            ssize_t n = ::write(fd_, data, len);
+            if (n <= 0) return;
+            data += n;
+            len -= n;
+        }
+    }
+
+private:
+    int fd_;
+};
+
+// 写回缓存的脏表按缓存分片划分，分片下标与缓存自身的分片一一对应
+template<typename Key, typename Value>
+size_t writeShardCount(LRUCache<Key, Value>&) { return 1; }
+
+template<typename Key, typename Value>
+size_t writeShardOf(LRUCache<Key, Value>&, const Key&) { return 0; }
+
+template<typename Key, typename Value>
+size_t writeShardCount(HashLRUCache<Key, Value>& cache) { return cache.sliceNum(); }
+
+template<typename Key, typename Value>
+size_t writeShardOf(HashLRUCache<Key, Value>& cache, const Key& key) { return cache.sliceOf(key); }
+
+// 写回（write-behind）缓存：
+// put 只写缓存并把 key 标记为脏，同一 key 的多次 put 合并为一次写；
+// 后台线程按批次把脏数据刷到 sink，被淘汰的脏数据也只是留在脏表里等下一批，put 不会同步写后端。
+// 脏表按缓存分片划分，写缓存与标记脏在该分片的锁内完成，刷盘时从缓存中读取当前值，
+// 缓存与写回的数据不会分叉；同一分片的淘汰只挤出同一分片的 key，所以被淘汰的值也落在同一个脏表分片。
+// 只有被淘汰的脏条目才在脏表中保存一份值，写回之前 get 仍能从脏表读到它。
+// CacheType 可以是 LRUCache 或 HashLRUCache，需提供 putAndEvict 与 peek
+template<typename Key, typename Value, typename CacheType = LRUCache<Key, Value>>
+class WriteBehindCache : public Cachepolicy<Key, Value>
+{
+public:
+    using SinkPtr = std::shared_ptr<WriteSink<Key, Value>>;
+    using ComputeFn = typename Cachepolicy<Key, Value>::ComputeFn;
+    using UpdateFn = typename Cachepolicy<Key, Value>::UpdateFn;
+
+    WriteBehindCache(std::unique_ptr<CacheType> cache, SinkPtr sink,
+                     size_t batchSize = 128,
+                     std::chrono::milliseconds flushInterval = std::chrono::milliseconds(10))
+        : cache_(std::move(cache)),
+          sink_(std::move(sink)),
+          batchSize_(batchSize > 0 ? batchSize : 1),
+          flushInterval_(flushInterval),
+          dirtyCount_(0),
+          stop_(false)
+    {
+        size_t shards = std::max<size_t>(1, writeShardCount(*cache_));
+        for (size_t i = 0; i < shards; ++i)
+        {
+            shards_.emplace_back(std::make_unique<DirtyShard>());
+        }
+        flusher_ = std::thread([this]() { run(); });
+    }
+
+    ~WriteBehindCache() override
+    {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex_);
+            stop_ = true;
+        }
+        cond_.notify_all();
+        flusher_.join();
+        flush();
+    }
+
+    WriteBehindCache(const WriteBehindCache&) = delete;
+    WriteBehindCache& operator=(const WriteBehindCache&) = delete;
+
+    void put(const Key& key, const Value& value) override
+    {
+        DirtyShard& shard = shardOf(key);
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            putLocked(shard, key, value);
+        }
+        wakeFlusher();
+    }
+
+    // 缓存未命中时再查脏表，被淘汰但尚未写回的值仍可读到
+    bool get(const Key& key, Value& value) override
+    {
+        if (cache_->get(key, value)) return true;
+
+        DirtyShard& shard = shardOf(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return lookupLocked(shard, key, value);
+    }
+
+    // 以下读-改-写操作与 put 在同一把分片锁内完成，写入同样标记为脏；fn 在锁内执行，不能再访问本缓存
+    Value compute(const Key& key, const ComputeFn& fn) override
+    {
+        DirtyShard& shard = shardOf(key);
+        Value value;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            Value old;
+            value = fn(lookupLocked(shard, key, old) ? &old : nullptr);
+            putLocked(shard, key, value);
+        }
+        wakeFlusher();
+        return value;
+    }
+
+    bool computeIfPresent(const Key& key, const UpdateFn& fn) override
+    {
+        return update(key, [&fn](const Value* old, Value& value) {
+            if (old == nullptr) return false;
+            value = fn(*old);
+            return true;
+        });
+    }
+
+    bool putIfAbsent(const Key& key, const Value& value) override
+    {
+        return update(key, [&value](const Value* old, Value& next) {
+            if (old != nullptr) return false;
+            next = value;
+            return true;
+        });
+    }
+
+    bool compareAndSet(const Key& key, const Value& expected, const Value& desired) override
+    {
+        return update(key, [&](const Value* old, Value& next) {
+            if (old == nullptr || !(*old == expected)) return false;
+            next = desired;
+            return true;
+        });
+    }
+
+    // 同步刷出全部脏数据
+    void flush()
+    {
+        std::lock_guard<std::mutex> flushLock(flushmutex_);
+        std::vector<std::pair<Key, Value>> batch;
+        takeDirty(batch, static_cast<size_t>(-1));
+        if (!batch.empty()) sink_->writeBatch(batch);
+    }
+
+    // 按顺序锁住全部分片，取出脏数据与清空缓存一起完成，清空不会丢失尚未落地的写入
+    void clear() override
+    {
+        std::lock_guard<std::mutex> flushLock(flushmutex_);
+        std::vector<std::pair<Key, Value>> batch;
+        {
+            std::vector<std::unique_lock<std::mutex>> locks;
+            locks.reserve(shards_.size());
+            for (auto& shard : shards_)
+            {
+                locks.emplace_back(shard->mutex);
+            }
+            for (auto& shard : shards_)
+            {
+                takeDirtyLocked(*shard, batch, static_cast<size_t>(-1));
+            }
+            cache_->clear();
+        }
+        if (!batch.empty()) sink_->writeBatch(batch);
+    }
+
+    size_t dirtySize() const
+    {
+        return dirtyCount_.load(std::memory_order_relaxed);
+    }
+
+private:
+    using Nodetype = typename LRUCache<Key, Value>::Nodetype;
+    // 尚未写回的 key，key 唯一即天然合并；值为空表示以缓存中的当前值为准，非空为已被淘汰的值
+    using DirtyMap = std::unordered_map<Key, std::optional<Value>>;
+
+    struct DirtyShard
+    {
+        std::mutex mutex;  // 同时保护该分片的缓存写入与脏表，两者总是一起更新
+        DirtyMap dirty;
+    };
+
+    DirtyShard& shardOf(const Key& key)
+    {
+        return *shards_[writeShardOf(*cache_, key) % shards_.size()];
+    }
+
+    // 先查缓存，再查脏表中被淘汰的值（需持分片锁）
+    bool lookupLocked(DirtyShard& shard, const Key& key, Value& value)
+    {
+        if (cache_->peek(key, value)) return true;
+        auto it = shard.dirty.find(key);
+        if (it == shard.dirty.end() || !it->second) return false;
+        value = *it->second;
+        return true;
+    }
+
+    // 写缓存并标记为脏，被淘汰的脏条目把值留在脏表中等刷盘线程写回（需持分片锁）
+    void putLocked(DirtyShard& shard, const Key& key, const Value& value)
+    {
+        Nodetype evicted;
+        bool hasEvicted = cache_->putAndEvict(key, value, evicted);
+        // 覆盖即合并，值以缓存中的为准
+        auto slot = shard.dirty.try_emplace(key);
+        if (slot.second)
+        {
+            dirtyCount_.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            slot.first->second.reset();
+        }
+        if (!hasEvicted) return;
+
+        auto it = shard.dirty.find(evicted.first);
+        if (it != shard.dirty.end()) it->second = std::move(evicted.second);
+    }
+
+    // fn(old, value) 在锁内决定是否写入及写入的值，返回是否写入
+    template<typename Fn>
+    bool update(const Key& key, Fn&& fn)
+    {
+        DirtyShard& shard = shardOf(key);
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            Value old;
+            Value value;
+            if (!fn(lookupLocked(shard, key, old) ? &old : nullptr, value)) return false;
+            putLocked(shard, key, value);
+        }
+        wakeFlusher();
+        return true;
+    }
+
+    // 脏数据攒够一批时唤醒刷盘线程；漏掉的唤醒由 flushInterval 兜底
+    void wakeFlusher()
+    {
+        if (dirtyCount_.load(std::memory_order_relaxed) >= batchSize_) cond_.notify_one();
+    }
+
+    void takeDirty(std::vector<std::pair<Key, Value>>& batch, size_t limit)
+    {
+        for (auto& shard : shards_)
+        {
+            if (batch.size() >= limit) break;
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            takeDirtyLocked(*shard, batch, limit);
+        }
+    }
+
+    void takeDirtyLocked(DirtyShard& shard, std::vector<std::pair<Key, Value>>& batch, size_t limit)
+    {
+        auto it = shard.dirty.begin();
+        while (it != shard.dirty.end() && batch.size() < limit)
+        {
+            it = takeEntry(shard, it, batch);
+        }
+    }
+
+    // 取出一个脏条目：已淘汰的用脏表中保存的值，仍在缓存中的读缓存当前值（需持分片锁）
+    typename DirtyMap::iterator takeEntry(DirtyShard& shard, typename DirtyMap::iterator it,
+                                          std::vector<std::pair<Key, Value>>& batch)
+    {
+        if (it->second)
+        {
+            batch.emplace_back(it->first, std::move(*it->second));
+        }
+        else
+        {
+            Value value;
+            if (cache_->peek(it->first, value)) batch.emplace_back(it->first, std::move(value));
+        }
+        dirtyCount_.fetch_sub(1, std::memory_order_relaxed);
+        return shard.dirty.erase(it);
+    }
+
+    void run()
+    {
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex_);
+                cond_.wait_for(lock, flushInterval_, [this]() {
+                    return stop_ || dirtyCount_.load(std::memory_order_relaxed) >= batchSize_;
+                });
+                if (stop_) break;
+            }
+            if (dirtyCount_.load(std::memory_order_relaxed) == 0) continue;
+
+            // 先拿 flushmutex_ 再取脏数据，保证同一 key 的写入顺序不会颠倒
+            std::lock_guard<std::mutex> flushLock(flushmutex_);
+            std::vector<std::pair<Key, Value>> batch;
+            batch.reserve(batchSize_);
+            takeDirty(batch, batchSize_);
+            if (!batch.empty()) sink_->writeBatch(batch);
+        }
+    }
+
+private:
+    std::unique_ptr<CacheType> cache_;
+    SinkPtr sink_;
+    size_t batchSize_;
+    std::chrono::milliseconds flushInterval_;
+    std::vector<std::unique_ptr<DirtyShard>> shards_;
+    std::atomic<size_t> dirtyCount_;  // 各分片脏条目数之和
+    bool stop_;
+    std::mutex wakeMutex_;   // 只配合 cond_ 使用，保护 stop_
+    std::mutex flushmutex_;  // 串行化对 sink 的写入
+    std::condition_variable cond_;
+    std::thread flusher_;  // 在构造函数体中最后启动
+};
+
+} // namespace CacheDemo
@@ -2,15 +2,44 @@
 #include <chrono>
 #include <thread>
 #include<atomic>
+#include <array>
 #include <vector>
 #include <iomanip>
 #include <random>
 #include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <memory_resource>
+#include <fstream>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 #include "../src/FIFOCache.h"
 #include "../src/LRUCache.h"
 #include "../src/LFUCache.h"
 #include "../src/ARCCache.h"
+#include "../src/TieredCache.h"
+#include "../src/CacheExecutor.h"
+#include "../src/RemovalListener.h"
+#include "../src/WriteBehindCache.h"
+#include "../src/HotKeyCache.h"
+#include "../src/EpochReclaim.h"
+#include "../src/S3FIFOCache.h"
+#include "../src/NumaCache.h"
+#include "../src/TwoLevelCache.h"
+#include "../src/PolicyCache.h"
+#include "../src/LIRSCache.h"
+#include "../src/SLRUCache.h"
+#include "../src/TwoQCache.h"
+#include "../src/ShardedCache.h"
+#include "../src/SampledCache.h"
+#include "../src/SetAssociativeCache.h"
+#include "../src/DenseCache.h"
+#include "../src/HugePageArena.h"
+#include "../src/AdaptiveCache.h"
+#include "../src/CompressedLRUCache.h"
 
 using namespace CacheDemo;
 
@@ -43,6 +72,8 @@ void printResults(const std::string& testName, int capacity,
             << (100.0 * hits[4] / get_operations[4]) << "%" << std::endl;
     std::cout << "ARC - 命中率: " << std::fixed << std::setprecision(2) 
             << (100.0 * hits[5] / get_operations[5]) << "%" << std::endl;
+    std::cout << "LIRS - 命中率: " << std::fixed << std::setprecision(2) 
+            << (100.0 * hits[6] / get_operations[6]) << "%" << std::endl;
 }
 
 
@@ -58,6 +89,8 @@ void print2Results(const std::string& testName, int capacity,
             << (100.0 * hits[1] / get_operations[1]) << "%" << std::endl;
     std::cout << "ARC - 命中率: " << std::fixed << std::setprecision(2) 
             << (100.0 * hits[2] / get_operations[2]) << "%" << std::endl;
+    std::cout << "LIRS - 命中率: " << std::fixed << std::setprecision(2) 
+            << (100.0 * hits[3] / get_operations[3]) << "%" << std::endl;
    
 }
 
@@ -329,13 +362,14 @@ void testHotDataAccess() {
     CacheDemo::LFUCache<int, std::string> lfu(CAPACITY);
     CacheDemo::LFUMCache<int, std::string> lfum(CAPACITY);
     CacheDemo::ArcCache<int, std::string> arc(CAPACITY);
+    CacheDemo::LIRSCache<int, std::string> lirs(CAPACITY);
 
     std::random_device rd;
     std::mt19937 gen(rd());
 
-    std::array<CacheDemo::Cachepolicy<int, std::string>*, 6> caches = {&fifo, &lru, &lruk, &lfu, &lfum, &arc};
-    std::vector<int> hits(6, 0);
-    std::vector<int> get_operations(6, 0);
+    std::array<CacheDemo::Cachepolicy<int, std::string>*, 7> caches = {&fifo, &lru, &lruk, &lfu, &lfum, &arc, &lirs};
+    std::vector<int> hits(7, 0);
+    std::vector<int> get_operations(7, 0);
 
     for (int i = 0; i < caches.size(); ++i) {
         for (int op = 0; op < OPERATIONS; ++op) {
@@ -381,10 +415,11 @@ void testLoopPattern() {
         CacheDemo::LRUCache<int, std::string> lru(CAPACITY);
         CacheDemo::LFUMCache<int, std::string> lfu(CAPACITY);
         CacheDemo::ArcCache<int, std::string> arc(CAPACITY);
+        CacheDemo::LIRSCache<int, std::string> lirs(CAPACITY);
     
-        std::array<CacheDemo::Cachepolicy<int, std::string>*, 3> caches = {&lru, &lfu, &arc};
-        std::vector<int> hits(3, 0);
-        std::vector<int> get_operations(3, 0);
+        std::array<CacheDemo::Cachepolicy<int, std::string>*, 4> caches = {&lru, &lfu, &arc, &lirs};
+        std::vector<int> hits(4, 0);
+        std::vector<int> get_operations(4, 0);
     
         std::random_device rd;
         std::mt19937 gen(rd());
@@ -430,12 +465,13 @@ void testWorkloadShift() {
         CacheDemo::LRUCache<int, std::string> lru(CAPACITY);
         CacheDemo::LFUMCache<int, std::string> lfu(CAPACITY);
         CacheDemo::ArcCache<int, std::string> arc(CAPACITY);
+        CacheDemo::LIRSCache<int, std::string> lirs(CAPACITY);
     
         std::random_device rd;
         std::mt19937 gen(rd());
-        std::array<CacheDemo::Cachepolicy<int, std::string>*, 3> caches = {&lru, &lfu, &arc};
-        std::vector<int> hits(3, 0);
-        std::vector<int> get_operations(3, 0);
+        std::array<CacheDemo::Cachepolicy<int, std::string>*, 4> caches = {&lru, &lfu, &arc, &lirs};
+        std::vector<int> hits(4, 0);
+        std::vector<int> get_operations(4, 0);
     
         // 先填充一些初始数据
         for (int i = 0; i < caches.size(); ++i) {
@@ -485,6 +521,1495 @@ void testWorkloadShift() {
 }
     
 
+// **内存+磁盘分层缓存测试**
+void testTieredCache() {
+    std::cout << "\n=== 测试场景4：内存+磁盘分层缓存 ===" << std::endl;
+
+    const int CAPACITY = 500;
+    const int KEYS = CAPACITY * 10;  // 工作集是内存容量的10倍
+    const int OPERATIONS = 200000;
+
+    CacheDemo::LRUCache<int, std::string> lru(CAPACITY);
+    CacheDemo::TieredLRUCache<int, std::string> tiered(CAPACITY, "/tmp/cachedemo_tier", 1 << 20, 8);
+
+    std::array<CacheDemo::Cachepolicy<int, std::string>*, 2> caches = {&lru, &tiered};
+    std::vector<int> hits(2, 0);
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+
+    for (int i = 0; i < caches.size(); ++i) {
+        for (int key = 0; key < KEYS; ++key) {
+            caches[i]->put(key, "value" + std::to_string(key));
+        }
+        for (int op = 0; op < OPERATIONS; ++op) {
+            int key = gen() % KEYS;
+            std::string result;
+            if (caches[i]->get(key, result)) {
+                if (result != "value" + std::to_string(key)) {
+                    std::cout << "分层缓存读到错误数据, key: " << key << std::endl;
+                }
+                hits[i]++;
+            }
+        }
+    }
+
+    std::cout << "缓存大小: " << CAPACITY << " 工作集: " << KEYS << std::endl;
+    std::cout << "LRU - 命中率: " << std::fixed << std::setprecision(2)
+            << (100.0 * hits[0] / OPERATIONS) << "%" << std::endl;
+    std::cout << "Tiered LRU - 命中率: " << std::fixed << std::setprecision(2)
+            << (100.0 * hits[1] / OPERATIONS) << "%" << std::endl;
+}
+
+// **后台淘汰测试：value 析构代价较大时比较 put 延迟**
+void testAsyncEviction() {
+    std::cout << "\n=== 测试场景5：后台维护线程淘汰 ===" << std::endl;
+
+    const int CAPACITY = 200;
+    const int OPERATIONS = 20000;
+    using BigValue = std::vector<std::string>;
+
+    auto run = [&](const std::string& name, std::shared_ptr<CacheDemo::CacheExecutor> executor) {
+        CacheDemo::LRUCache<int, BigValue> lru(CAPACITY);
+        CacheDemo::LFUMCache<int, BigValue> lfum(CAPACITY);
+        CacheDemo::ArcCache<int, BigValue> arc(CAPACITY);
+        if (executor) {
+            lru.setExecutor(executor);
+            lfum.setExecutor(executor);
+            arc.setExecutor(executor);
+        }
+
+        std::array<CacheDemo::Cachepolicy<int, BigValue>*, 3> caches = {&lru, &lfum, &arc};
+        const char* names[] = {"LRU", "LFUM", "ARC"};
+        for (int i = 0; i < caches.size(); ++i) {
+            double total = 0, worst = 0;
+            for (int op = 0; op < OPERATIONS; ++op) {
+                BigValue value(256, "payload" + std::to_string(op));
+                auto start = std::chrono::high_resolution_clock::now();
+                caches[i]->put(op, std::move(value));
+                auto end = std::chrono::high_resolution_clock::now();
+                double us = std::chrono::duration<double, std::micro>(end - start).count();
+                total += us;
+                worst = std::max(worst, us);
+            }
+            std::cout << name << " " << names[i] << " - put 平均: " << std::fixed << std::setprecision(2)
+                      << total / OPERATIONS << " us, 最大: " << worst << " us" << std::endl;
+        }
+        if (executor) executor->flush();
+    };
+
+    run("同步淘汰", nullptr);
+    run("后台淘汰", std::make_shared<CacheDemo::CacheExecutor>());
+}
+
+// **移除监听测试：统计各策略上报的移除事件**
+void testRemovalListener() {
+    std::cout << "\n=== 测试场景6：移除事件监听 ===" << std::endl;
+
+    const int CAPACITY = 50;
+    const int KEYS = 500;
+
+    std::atomic<int> counts[4] = {};
+    auto dispatcher = std::make_shared<CacheDemo::RemovalDispatcher<int, std::string>>(
+        [&counts](const std::vector<CacheDemo::RemovalNotification<int, std::string>>& batch) {
+            for (auto& n : batch) {
+                counts[static_cast<int>(n.cause)]++;
+            }
+        });
+
+    CacheDemo::LRUCache<int, std::string> lru(CAPACITY);
+    CacheDemo::LFUCache<int, std::string> lfu(CAPACITY);
+    CacheDemo::ArcCache<int, std::string> arc(CAPACITY);
+    lru.setRemovalListener(dispatcher);
+    lfu.setRemovalListener(dispatcher);
+    arc.setRemovalListener(dispatcher);
+
+    std::array<CacheDemo::Cachepolicy<int, std::string>*, 3> caches = {&lru, &lfu, &arc};
+    const char* names[] = {"LRU", "LFU", "ARC"};
+    for (int i = 0; i < caches.size(); ++i) {
+        for (auto& c : counts) c = 0;
+        for (int key = 0; key < KEYS; ++key) {
+            caches[i]->put(key, "value" + std::to_string(key));
+        }
+        caches[i]->put(KEYS - 1, "updated");
+        if (i == 0) lru.deletenode(KEYS - 2);
+        if (i == 1) lfu.deletenode(KEYS - 2);
+        dispatcher->flush();
+
+        std::cout << names[i] << " - 容量淘汰: " << counts[0] << " 主动删除: " << counts[1]
+                  << " 覆盖: " << counts[2] << std::endl;
+    }
+    // 只留在 ARC 的 LFU 部分的 key：访问两次迁入 LFU 部分，再被挤出 LRU 部分
+    CacheDemo::ArcCache<int, std::string> small(2);
+    small.setRemovalListener(dispatcher);
+    std::string value;
+    small.put(1, "a");
+    small.get(1, value);
+    small.put(2, "b");
+    small.put(3, "c");
+    dispatcher->flush();
+    for (auto& c : counts) c = 0;
+    small.put(1, "d");
+    dispatcher->flush();
+    std::cout << "ARC 覆盖仅在 LFU 部分的 key - 覆盖: " << counts[2] << (counts[2] == 1 ? " 通过" : " 失败")
+              << std::endl;
+}
+
+// **写回缓存测试：统计合并后的后端写入次数并校验最终数据**
+void testWriteBehind() {
+    std::cout << "\n=== 测试场景7：写回缓存合并写入 ===" << std::endl;
+
+    const int CAPACITY = 100;
+    const int KEYS = 1000;
+    const int OPERATIONS = 200000;
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+
+    auto lruSink = std::make_shared<CacheDemo::MemorySink<int, std::string>>();
+    auto hashSink = std::make_shared<CacheDemo::MemorySink<int, std::string>>();
+    std::vector<std::string> expected(KEYS);
+    {
+        CacheDemo::WriteBehindCache<int, std::string> lru(
+            std::make_unique<CacheDemo::LRUCache<int, std::string>>(CAPACITY), lruSink);
+        CacheDemo::WriteBehindCache<int, std::string, CacheDemo::HashLRUCache<int, std::string>> hashlru(
+            std::make_unique<CacheDemo::HashLRUCache<int, std::string>>(CAPACITY, 4), hashSink);
+
+        for (int op = 0; op < OPERATIONS; ++op) {
+            // 70% 的更新落在 50 个热点 key 上
+            int key = (op % 100 < 70) ? gen() % 50 : gen() % KEYS;
+            expected[key] = "value" + std::to_string(op);
+            lru.put(key, expected[key]);
+            hashlru.put(key, expected[key]);
+        }
+    }  // 析构时刷出剩余脏数据
+
+    int mismatch = 0;
+    for (int key = 0; key < KEYS; ++key) {
+        std::string a, b;
+        if (expected[key].empty()) continue;
+        if (!lruSink->get(key, a) || a != expected[key]) mismatch++;
+        if (!hashSink->get(key, b) || b != expected[key]) mismatch++;
+    }
+
+    std::cout << "put 次数: " << OPERATIONS << std::endl;
+    std::cout << "LRU 写回 - 后端写入: " << lruSink->writeCount() << " 批次: " << lruSink->batchCount() << std::endl;
+    std::cout << "HASHLRU 写回 - 后端写入: " << hashSink->writeCount() << " 批次: " << hashSink->batchCount() << std::endl;
+    std::cout << "数据不一致: " << mismatch << std::endl;
+}
+
+// **在线扩缩容测试：读写流量不停的情况下调整分片缓存容量**
+void testOnlineResize() {
+    std::cout << "\n=== 测试场景8：分片缓存在线扩缩容 ===" << std::endl;
+
+    const int CAPACITY = 20000;
+    const int KEYS = 50000;
+
+    CacheDemo::HashLRUCache<int, std::string> lru(CAPACITY, 4);
+    CacheDemo::HashLFUCache<int, std::string> lfu(CAPACITY, 4);
+
+    std::atomic<bool> stop(false);
+    std::atomic<double> worst(0);
+    auto traffic = [&]() {
+        std::mt19937 gen(42);
+        std::string result;
+        while (!stop) {
+            int key = gen() % KEYS;
+            auto start = std::chrono::high_resolution_clock::now();
+            lru.put(key, "value" + std::to_string(key));
+            lfu.put(key, "value" + std::to_string(key));
+            lru.get(gen() % KEYS, result);
+            lfu.get(gen() % KEYS, result);
+            auto end = std::chrono::high_resolution_clock::now();
+            double us = std::chrono::duration<double, std::micro>(end - start).count();
+            if (us > worst) worst = us;
+        }
+    };
+
+    for (int key = 0; key < KEYS; ++key) {
+        lru.put(key, "value" + std::to_string(key));
+        lfu.put(key, "value" + std::to_string(key));
+    }
+
+    std::thread worker(traffic);
+    for (size_t cap : {2000, 30000, 10000}) {
+        lru.resize(cap);
+        lfu.resize(cap);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        std::cout << "调整容量到 " << cap << " - HASHLRU 当前大小: " << lru.size()
+                  << " HASHLFU 当前大小: " << lfu.size() << std::endl;
+    }
+    lru.rebalance();
+    lfu.rebalance();
+    stop = true;
+    worker.join();
+
+    std::cout << "再平衡后 - HASHLRU 当前大小: " << lru.size() << " HASHLFU 当前大小: " << lfu.size() << std::endl;
+    std::cout << "调整期间单次操作最大耗时: " << std::fixed << std::setprecision(2) << worst.load() << " us" << std::endl;
+}
+
+// **热点复制测试：Zipf 分布下比较分片 LRU 与带热点复制的分片 LRU 的吞吐**
+void testHotKeyReplication() {
+    std::cout << "\n=== 测试场景9：热点 key 复制 ===" << std::endl;
+
+    const int CAPACITY = 1000;
+    const int KEYS = 10000;
+    const int OPERATIONS = 1000000;
+    const int threadnum = 4;
+
+    // Zipf(1.1) 分布
+    std::vector<double> weights(KEYS);
+    for (int i = 0; i < KEYS; ++i) {
+        weights[i] = 1.0 / std::pow(i + 1, 1.1);
+    }
+
+    CacheDemo::HashLRUCache<int, std::string> plain(CAPACITY, threadnum);
+    CacheDemo::HotKeyHashLRUCache<int, std::string> hot(CAPACITY, threadnum);
+    for (int key = 0; key < KEYS; ++key) {
+        plain.put(key, "value" + std::to_string(key));
+        hot.put(key, "value" + std::to_string(key));
+    }
+
+    auto run = [&](const std::string& name, auto& cache) {
+        std::atomic<int> hit_count(0);
+        auto task = [&]() {
+            std::mt19937 gen(std::random_device{}());
+            std::discrete_distribution<int> zipf(weights.begin(), weights.end());
+            std::string result;
+            for (int i = 0; i < OPERATIONS / threadnum; ++i) {
+                int key = zipf(gen);
+                if (cache.get(key, result)) {
+                    hit_count++;
+                } else {
+                    cache.put(key, "value" + std::to_string(key));
+                }
+            }
+        };
+
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<std::thread> threads;
+        for (int i = 0; i < threadnum; ++i) {
+            threads.emplace_back(task);
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        std::cout << name << " - 命中率: " << std::fixed << std::setprecision(2)
+                  << (100.0 * hit_count.load() / OPERATIONS) << "% 吞吐: "
+                  << (OPERATIONS / ms) << " ops/ms" << std::endl;
+    };
+
+    run("HASHLRU", plain);
+    run("HOTKEY HASHLRU", hot);
+    // 副本命中的 get 不加分片锁；吞吐差异取决于核数和分片锁的争用程度，核数少时两者接近
+    std::vector<int> hotKeys = hot.hotKeys();
+    double total = std::accumulate(weights.begin(), weights.end(), 0.0);
+    double covered = 0;
+    for (int key : hotKeys) {
+        covered += weights[key];
+    }
+    std::cout << "识别出的热点 key 数: " << hotKeys.size() << " 约 " << std::fixed << std::setprecision(2)
+              << 100.0 * covered / total << "% 的 get 走无锁副本 (CPU 核数: "
+              << std::thread::hardware_concurrency() << ")" << std::endl;
+}
+
+// **纪元回收测试：读者无锁查询，写者并发覆盖/删除，校验读到的值始终完整**
+void testEpochReclaim() {
+    std::cout << "\n=== 测试场景10：纪元回收并发哈希索引 ===" << std::endl;
+
+    const int KEYS = 1000;
+    const int OPERATIONS = 1000000;
+    const int readers = 3;
+
+    CacheDemo::ConcurrentHashIndex<int, std::string> index(KEYS);
+    for (int key = 0; key < KEYS; ++key) {
+        index.insertOrAssign(key, "value" + std::to_string(key));
+    }
+
+    std::atomic<bool> stop(false);
+    std::atomic<int> broken(0);
+    std::atomic<long> hits(0);
+
+    auto reader = [&]() {
+        std::mt19937 gen(std::random_device{}());
+        std::string result;
+        for (int i = 0; i < OPERATIONS / readers; ++i) {
+            int key = gen() % KEYS;
+            if (index.find(key, result)) {
+                hits++;
+                if (result != "value" + std::to_string(key)) broken++;
+            }
+        }
+    };
+
+    auto writer = [&]() {
+        std::mt19937 gen(std::random_device{}());
+        while (!stop) {
+            int key = gen() % KEYS;
+            if (gen() % 4 == 0) {
+                index.erase(key);
+            } else {
+                index.insertOrAssign(key, "value" + std::to_string(key));
+            }
+        }
+    };
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::thread w(writer);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < readers; ++i) {
+        threads.emplace_back(reader);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    stop = true;
+    w.join();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    std::cout << "无锁读命中: " << hits.load() << " 数据损坏: " << broken.load()
+              << " 读吞吐: " << std::fixed << std::setprecision(2) << (OPERATIONS / ms) << " ops/ms" << std::endl;
+}
+
+// **S3-FIFO 测试：命中率与多线程吞吐**
+void testS3FIFO() {
+    std::cout << "\n=== 测试场景11：S3-FIFO ===" << std::endl;
+
+    const int CAPACITY = 50;
+    const int OPERATIONS = 1000000;
+    const int HOT_KEYS = 20;
+    const int COLD_KEYS = 5000;
+    const int threadnum = 4;
+
+    CacheDemo::LRUCache<int, std::string> lru(CAPACITY);
+    CacheDemo::ArcCache<int, std::string> arc(CAPACITY);
+    CacheDemo::S3FIFOCache<int, std::string> s3fifo(CAPACITY);
+
+    std::array<CacheDemo::Cachepolicy<int, std::string>*, 3> caches = {&lru, &arc, &s3fifo};
+    const char* names[] = {"LRU", "ARC", "S3FIFO"};
+
+    for (int i = 0; i < caches.size(); ++i) {
+        std::atomic<int> hit_count(0);
+        // 读未命中时回填，模拟真实的 cache-aside 访问
+        auto task = [&]() {
+            std::mt19937 gen(std::random_device{}());
+            std::string result;
+            for (int op = 0; op < OPERATIONS / threadnum; ++op) {
+                int key = (op % 100 < 70) ? gen() % HOT_KEYS : HOT_KEYS + (gen() % COLD_KEYS);
+                if (caches[i]->get(key, result)) {
+                    hit_count++;
+                } else {
+                    caches[i]->put(key, "value" + std::to_string(key));
+                }
+            }
+        };
+
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadnum; ++t) {
+            threads.emplace_back(task);
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        std::cout << names[i] << " - 命中率: " << std::fixed << std::setprecision(2)
+                  << (100.0 * hit_count.load() / OPERATIONS) << "% 吞吐: " << (OPERATIONS / ms) << " ops/ms" << std::endl;
+    }
+
+    // 未超出容量时反复覆盖同一个 key，不应淘汰其他条目
+    CacheDemo::S3FIFOCache<int, int> overwrite(100);
+    for (int key = 0; key < 100; ++key) {
+        overwrite.put(key, key);
+    }
+    for (int round = 0; round < 2000; ++round) {
+        overwrite.put(0, round);
+    }
+    int kept = 0;
+    for (int key = 0; key < 100; ++key) {
+        int value;
+        if (overwrite.get(key, value)) ++kept;
+    }
+    std::cout << "反复覆盖后保留: " << kept << "/100 " << (kept == 100 ? "通过" : "失败") << std::endl;
+}
+
+// **NUMA 分片测试：节点本地分配 + 线程按节点处理请求**
+void testNumaSharding() {
+    std::cout << "\n=== 测试场景12：NUMA分片 ===" << std::endl;
+
+    const int CAPACITY = 10000;
+    const int OPERATIONS = 400000;
+    const int KEYS = 20000;
+    const int threadnum = 4;
+
+    CacheDemo::NumaHashLRUCache<int, int> cache(CAPACITY, 4);
+    int nodes = cache.nodeCount();
+    std::cout << "节点数: " << nodes << " 节点本地分配: " << (cache.nodeLocal() ? "是" : "否(回退)") << std::endl;
+
+    std::atomic<int> hits(0);
+    std::atomic<int> broken(0);
+    // 线程 t 绑到节点 t % nodes，只处理落在本节点分片上的 key
+    auto task = [&](int t) {
+        int node = t % nodes;
+        CacheDemo::NumaHashLRUCache<int, int>::bindCurrentThread(node);
+        std::mt19937 gen(t);
+        int value;
+        for (int op = 0; op < OPERATIONS / threadnum; ++op) {
+            int key = gen() % KEYS;
+            if (cache.nodeOf(key) != node) continue;
+            if (cache.get(key, value)) {
+                hits++;
+                if (value != key * 3) broken++;
+            } else {
+                cache.put(key, key * 3);
+            }
+        }
+    };
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadnum; ++t) {
+        threads.emplace_back(task, t);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+    std::cout << "命中: " << hits.load() << " 数据损坏: " << broken.load()
+              << " 条目数: " << cache.size() << "/" << cache.capacity()
+              << " 耗时: " << std::fixed << std::setprecision(2) << ms << " ms" << std::endl;
+}
+
+// **两级缓存测试：线程本地 L1 + 共享分片 L2**
+void testTwoLevelCache() {
+    std::cout << "\n=== 测试场景13：线程本地L1两级缓存 ===" << std::endl;
+
+    const int CAPACITY = 5000;
+    const int OPERATIONS = 1000000;
+    const int HOT_KEYS = 200;
+    const int COLD_KEYS = 20000;
+    const int threadnum = 4;
+
+    CacheDemo::LRUCache<int, int> shared(CAPACITY);
+    CacheDemo::TwoLevelCache<int, int> twoLevel(std::make_unique<CacheDemo::LRUCache<int, int>>(CAPACITY), 512);
+
+    std::array<CacheDemo::Cachepolicy<int, int>*, 2> caches = {&shared, &twoLevel};
+    const char* names[] = {"LRU", "L1+LRU"};
+
+    for (int i = 0; i < caches.size(); ++i) {
+        std::atomic<int> hit_count(0);
+        std::atomic<int> stale(0);
+        // 每 50 次操作写一次，让 L1 副本持续被其他线程的写入作废
+        auto task = [&](int t) {
+            std::mt19937 gen(t);
+            int value;
+            for (int op = 0; op < OPERATIONS / threadnum; ++op) {
+                int key = (op % 100 < 90) ? gen() % HOT_KEYS : HOT_KEYS + (gen() % COLD_KEYS);
+                if (op % 50 == 0) {
+                    caches[i]->put(key, key * 10 + t);
+                    continue;
+                }
+                if (caches[i]->get(key, value)) {
+                    hit_count++;
+                    if (value / 10 != key) stale++;
+                } else {
+                    caches[i]->put(key, key * 10 + t);
+                }
+            }
+        };
+
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadnum; ++t) {
+            threads.emplace_back(task, t);
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        std::cout << names[i] << " - 命中率: " << std::fixed << std::setprecision(2)
+                  << (100.0 * hit_count.load() / OPERATIONS) << "% 吞吐: " << (OPERATIONS / ms)
+                  << " ops/ms 错误数据: " << stale.load() << std::endl;
+    }
+    std::cout << "L1命中次数: " << twoLevel.l1Hits() << std::endl;
+
+    // 读线程先把 key 读进自己的 L1，主线程更新后它必须读到新值
+    twoLevel.put(1, 100);
+    std::atomic<int> step(0);
+    int seen = 0;
+    std::thread reader([&]() {
+        twoLevel.get(1, seen);
+        step = 1;
+        while (step.load() != 2) std::this_thread::yield();
+        twoLevel.get(1, seen);
+    });
+    while (step.load() != 1) std::this_thread::yield();
+    twoLevel.put(1, 200);
+    step = 2;
+    reader.join();
+    std::cout << "跨线程更新后读到: " << seen << (seen == 200 ? " (正确)" : " (过期)") << std::endl;
+}
+
+// **策略组合测试：编译期组合 vs 虚接口**
+template <typename CacheType>
+double runPolicyWorkload(CacheType& cache, int operations, int& hits) {
+    std::mt19937 gen(42);
+    int value;
+    hits = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int op = 0; op < operations; ++op) {
+        int key = (op % 100 < 70) ? gen() % 20 : 20 + (gen() % 5000);
+        if (cache.get(key, value)) {
+            hits++;
+        } else {
+            cache.put(key, key);
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void testPolicyComposition() {
+    std::cout << "\n=== 测试场景14：编译期策略组合 ===" << std::endl;
+
+    const int CAPACITY = 50;
+    const int OPERATIONS = 1000000;
+    int hits = 0;
+
+    // 单线程：虚接口 + 互斥锁 对比 内联 + 无锁
+    CacheDemo::LRUCache<int, int> virtualLru(CAPACITY);
+    CacheDemo::Cachepolicy<int, int>& viaInterface = virtualLru;
+    double ms = runPolicyWorkload(viaInterface, OPERATIONS, hits);
+    std::cout << "LRUCache(虚接口) - 命中率: " << std::fixed << std::setprecision(2)
+              << (100.0 * hits / OPERATIONS) << "% 吞吐: " << (OPERATIONS / ms) << " ops/ms" << std::endl;
+
+    CacheDemo::Cache<int, int, CacheDemo::LRUEviction, CacheDemo::HashIndex, CacheDemo::NoLocking> inlineLru(CAPACITY);
+    ms = runPolicyWorkload(inlineLru, OPERATIONS, hits);
+    std::cout << "Cache<LRU,无锁> - 命中率: " << (100.0 * hits / OPERATIONS) << "% 吞吐: " << (OPERATIONS / ms) << " ops/ms" << std::endl;
+
+    CacheDemo::Cache<int, int, CacheDemo::LRUEviction, CacheDemo::HashIndex, CacheDemo::SpinLocking> spinLru(CAPACITY);
+    ms = runPolicyWorkload(spinLru, OPERATIONS, hits);
+    std::cout << "Cache<LRU,自旋锁> - 命中率: " << (100.0 * hits / OPERATIONS) << "% 吞吐: " << (OPERATIONS / ms) << " ops/ms" << std::endl;
+
+    // 各淘汰策略经类型擦除适配器走原有接口
+    CacheDemo::CachepolicyAdapter<CacheDemo::Cache<int, int, CacheDemo::FIFOEviction>> fifo(CAPACITY);
+    CacheDemo::CachepolicyAdapter<CacheDemo::Cache<int, int, CacheDemo::LRUEviction, CacheDemo::TreeIndex>> lru(CAPACITY);
+    CacheDemo::CachepolicyAdapter<CacheDemo::Cache<int, int, CacheDemo::LFUEviction>> lfu(CAPACITY);
+    CacheDemo::CachepolicyAdapter<CacheDemo::Cache<int, int, CacheDemo::ARCEviction,
+        CacheDemo::HashIndex, CacheDemo::MutexLocking, CacheDemo::CountingStats>> arc(CAPACITY);
+
+    std::array<CacheDemo::Cachepolicy<int, int>*, 4> caches = {&fifo, &lru, &lfu, &arc};
+    const char* names[] = {"FIFO", "LRU(有序索引)", "LFU", "ARC"};
+    for (int i = 0; i < caches.size(); ++i) {
+        ms = runPolicyWorkload(*caches[i], OPERATIONS, hits);
+        std::cout << names[i] << " - 命中率: " << (100.0 * hits / OPERATIONS) << "% 吞吐: " << (OPERATIONS / ms) << " ops/ms" << std::endl;
+    }
+    auto& stats = arc.cache().stats();
+    std::cout << "ARC统计 - 命中: " << stats.hits() << " 未命中: " << stats.misses()
+              << " 淘汰: " << stats.evictions() << " 条目数: " << arc.cache().size() << std::endl;
+}
+
+// **清空测试：各策略 clear 后为空，大缓存清空不阻塞并发访问**
+void testClear() {
+    std::cout << "\n=== 测试场景15：批量清空 ===" << std::endl;
+
+    const int CAPACITY = 1000;
+
+    CacheDemo::FIFOCache<int, std::string> fifo(CAPACITY);
+    CacheDemo::LRUCache<int, std::string> lru(CAPACITY);
+    CacheDemo::LRUKCache<int, std::string> lruk(CAPACITY, CAPACITY, 2);
+    CacheDemo::LFUCache<int, std::string> lfu(CAPACITY);
+    CacheDemo::LFUMCache<int, std::string> lfum(CAPACITY);
+    CacheDemo::ArcCache<int, std::string> arc(CAPACITY);
+    CacheDemo::S3FIFOCache<int, std::string> s3fifo(CAPACITY);
+    CacheDemo::CachepolicyAdapter<CacheDemo::Cache<int, std::string, CacheDemo::LFUEviction>> composed(CAPACITY);
+
+    std::array<CacheDemo::Cachepolicy<int, std::string>*, 8> caches = {&fifo, &lru, &lruk, &lfu, &lfum, &arc, &s3fifo, &composed};
+    const char* names[] = {"FIFO", "LRU", "LRU-K", "LFU", "LFUM", "ARC", "S3FIFO", "Cache<LFU>"};
+    for (int i = 0; i < caches.size(); ++i) {
+        for (int key = 0; key < CAPACITY * 2; ++key) {
+            caches[i]->put(key, "value" + std::to_string(key));
+            caches[i]->put(key, "value" + std::to_string(key));
+        }
+        caches[i]->clear();
+        int remaining = 0;
+        std::string value;
+        for (int key = 0; key < CAPACITY * 2; ++key) {
+            if (caches[i]->get(key, value)) remaining++;
+        }
+        // 清空后仍可正常使用（写两次，满足 LRU-K 的准入次数）
+        caches[i]->put(1, "again");
+        caches[i]->put(1, "again");
+        bool reusable = caches[i]->get(1, value) && value == "again";
+        std::cout << names[i] << " - 清空后残留: " << remaining << " 可继续使用: " << (reusable ? "是" : "否") << std::endl;
+    }
+
+    CacheDemo::HashLFUCache<int, std::string> hashLfu(CAPACITY, 4);
+    for (int key = 0; key < CAPACITY; ++key) hashLfu.put(key, "v");
+    hashLfu.purge();
+    std::cout << "HASHLFU purge 后大小: " << hashLfu.size() << std::endl;
+
+    // 大缓存清空：旧节点交给后台线程析构，并发读的最大延迟不应随缓存大小增长
+    const int BIG = 1000000;
+    auto executor = std::make_shared<CacheDemo::CacheExecutor>();
+    CacheDemo::LRUCache<int, std::string> big(BIG);
+    big.setExecutor(executor);
+    for (int key = 0; key < BIG; ++key) big.put(key, "value" + std::to_string(key));
+
+    std::atomic<bool> running(true);
+    double maxGetUs = 0;
+    std::thread reader([&]() {
+        std::string value;
+        int key = 0;
+        while (running.load()) {
+            auto start = std::chrono::high_resolution_clock::now();
+            big.get(key++ % BIG, value);
+            auto end = std::chrono::high_resolution_clock::now();
+            maxGetUs = std::max(maxGetUs, std::chrono::duration<double, std::micro>(end - start).count());
+        }
+    });
+
+    auto start = std::chrono::high_resolution_clock::now();
+    big.clear();
+    auto end = std::chrono::high_resolution_clock::now();
+    running = false;
+    reader.join();
+    executor->flush();
+
+    std::cout << "清空 " << BIG << " 条 - clear 耗时: " << std::fixed << std::setprecision(2)
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms 并发读最大延迟: "
+              << maxGetUs << " us 清空后大小: " << big.size() << std::endl;
+}
+
+// **原子读改写测试：并发计数不丢更新，各策略语义一致**
+void testAtomicOps() {
+    std::cout << "\n=== 测试场景16：原子读改写 ===" << std::endl;
+
+    const int COUNTERS = 64;
+    const int OPERATIONS = 400000;
+    const int threadnum = 4;
+
+    // get + put 与 compute 做同样的并发自增，比较丢失的更新数
+    CacheDemo::HashLRUCache<int, int> racy(COUNTERS, 4);
+    CacheDemo::HashLRUCache<int, int> atomic(COUNTERS, 4);
+
+    auto run = [&](bool useCompute) {
+        auto task = [&]() {
+            for (int op = 0; op < OPERATIONS / threadnum; ++op) {
+                int key = op % COUNTERS;
+                if (useCompute) {
+                    atomic.compute(key, [](const int* old) { return old ? *old + 1 : 1; });
+                } else {
+                    int value = 0;
+                    racy.get(key, value);
+                    std::this_thread::yield();  // 放大 get 与 put 之间的竞争窗口
+                    racy.put(key, value + 1);
+                }
+            }
+        };
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadnum; ++t) {
+            threads.emplace_back(task);
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    };
+
+    run(false);
+    double atomicMs = run(true);
+    long racyTotal = 0;
+    long atomicTotal = 0;
+    for (int key = 0; key < COUNTERS; ++key) {
+        racyTotal += racy.get(key);
+        atomicTotal += atomic.get(key);
+    }
+    std::cout << "get+put - 计数: " << racyTotal << "/" << OPERATIONS << std::endl;
+    std::cout << "compute - 计数: " << atomicTotal << "/" << OPERATIONS << " 耗时: "
+              << std::fixed << std::setprecision(2) << atomicMs << " ms" << std::endl;
+
+    // 各策略的 putIfAbsent / compareAndSet / computeIfPresent 语义
+    const int CAPACITY = 16;
+    CacheDemo::FIFOCache<int, int> fifo(CAPACITY);
+    CacheDemo::LRUCache<int, int> lru(CAPACITY);
+    CacheDemo::LFUCache<int, int> lfu(CAPACITY);
+    CacheDemo::LFUMCache<int, int> lfum(CAPACITY);
+    CacheDemo::ArcCache<int, int> arc(CAPACITY);
+    CacheDemo::CachepolicyAdapter<CacheDemo::Cache<int, int, CacheDemo::LRUEviction>> composed(CAPACITY);
+
+    std::array<CacheDemo::Cachepolicy<int, int>*, 6> caches = {&fifo, &lru, &lfu, &lfum, &arc, &composed};
+    const char* names[] = {"FIFO", "LRU", "LFU", "LFUM", "ARC", "Cache<LRU>"};
+    for (int i = 0; i < caches.size(); ++i) {
+        auto* cache = caches[i];
+        bool ok = cache->putIfAbsent(1, 10) && !cache->putIfAbsent(1, 20)
+            && !cache->compareAndSet(1, 20, 30) && cache->compareAndSet(1, 10, 30)
+            && cache->computeIfPresent(1, [](const int& v) { return v + 1; })
+            && !cache->computeIfPresent(2, [](const int& v) { return v + 1; })
+            && cache->compute(2, [](const int* old) { return old ? *old : 7; }) == 7;
+        int v1 = 0;
+        int v2 = 0;
+        ok = ok && cache->get(1, v1) && v1 == 31 && cache->get(2, v2) && v2 == 7;
+        std::cout << names[i] << " - 语义检查: " << (ok ? "通过" : "失败") << std::endl;
+    }
+}
+
+// 统计经过的分配量，用于检查缓存的内存是否全部来自传入的 resource
+class CountingResource : public std::pmr::memory_resource {
+public:
+    std::atomic<long> outstanding{0};
+    std::atomic<long> allocations{0};
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        outstanding += bytes;
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        outstanding -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// **内存资源测试：分片独立内存池与全局分配器对比，各策略的分配都走传入的 resource**
+void testPmrAllocation() {
+    std::cout << "\n=== 测试场景17：内存资源 ===" << std::endl;
+
+    const int CAPACITY = 4096;
+    const int OPERATIONS = 400000;
+    const int threadnum = 4;
+    const int KEY_RANGE = CAPACITY * 4;
+
+    // 高淘汰率负载，put 和淘汰都要分配/释放节点
+    auto churn = [&](auto& cache) {
+        auto task = [&](int t) {
+            std::mt19937 gen(t);
+            std::uniform_int_distribution<> dist(0, KEY_RANGE - 1);
+            int value = 0;
+            for (int op = 0; op < OPERATIONS / threadnum; ++op) {
+                int key = dist(gen);
+                if (!cache.get(key, value)) cache.put(key, key);
+            }
+        };
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadnum; ++t) {
+            threads.emplace_back(task, t);
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    };
+
+    {
+        // 多个分片共用一个 resource，必须是线程安全的
+        std::pmr::synchronized_pool_resource pool;
+        CacheDemo::HashLRUCache<int, int> global(CAPACITY, threadnum);
+        CacheDemo::HashLRUCache<int, int> pooled(CAPACITY, threadnum, &pool);
+        CacheDemo::HashLFUCache<int, int> lfuGlobal(CAPACITY, threadnum);
+        CacheDemo::HashLFUCache<int, int> lfuPooled(CAPACITY, threadnum, &pool);
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "HashLRU 全局分配器 - 耗时: " << churn(global) << " ms" << std::endl;
+        std::cout << "HashLRU 同步内存池 - 耗时: " << churn(pooled) << " ms" << std::endl;
+        std::cout << "HashLFU 全局分配器 - 耗时: " << churn(lfuGlobal) << " ms" << std::endl;
+        std::cout << "HashLFU 同步内存池 - 耗时: " << churn(lfuPooled) << " ms" << std::endl;
+    }
+
+    // 每种策略各用一个计数 resource：运行期间有分配，析构后全部归还
+    CountingResource resources[6];
+    long peak[6] = {};
+    {
+        CacheDemo::FIFOCache<int, int> fifo(CAPACITY, &resources[0]);
+        CacheDemo::LRUCache<int, int> lru(CAPACITY, &resources[1]);
+        CacheDemo::LFUCache<int, int> lfu(CAPACITY, &resources[2]);
+        CacheDemo::LFUMCache<int, int> lfum(CAPACITY, CacheDemo::MAX_FREQ, &resources[3]);
+        CacheDemo::ArcCache<int, int> arc(CAPACITY, 2, &resources[4]);
+        CacheDemo::LRUKCache<int, int> lruk(CAPACITY, CAPACITY, 2, &resources[5]);
+
+        std::array<CacheDemo::Cachepolicy<int, int>*, 6> caches = {&fifo, &lru, &lfu, &lfum, &arc, &lruk};
+        for (int i = 0; i < caches.size(); ++i) {
+            churn(*caches[i]);
+            caches[i]->clear();
+            churn(*caches[i]);
+            peak[i] = resources[i].outstanding;
+        }
+    }
+    const char* names[] = {"FIFO", "LRU", "LFU", "LFUM", "ARC", "LRU-K"};
+    for (int i = 0; i < 6; ++i) {
+        bool ok = peak[i] > 0 && resources[i].outstanding == 0;
+        std::cout << names[i] << " - 分配次数: " << resources[i].allocations
+                  << " 析构后未归还: " << resources[i].outstanding << " 字节 "
+                  << (ok ? "通过" : "失败") << std::endl;
+    }
+}
+
+// **未命中过滤测试：约 40% 的 get 查询不存在的 key，过滤器让这些查询不加锁直接返回**
+void testMissFilter() {
+    std::cout << "\n=== 测试场景18：未命中过滤 ===" << std::endl;
+
+    const int CAPACITY = 20000;
+    const int OPERATIONS = 2000000;
+    const int threadnum = 4;
+    const int MISS_PERCENT = 40;
+
+    CacheDemo::HashLRUCache<int, int> plain(CAPACITY, threadnum);
+    CacheDemo::HashLRUCache<int, int> filtered(CAPACITY, threadnum);
+    filtered.enableMissFilter();
+    for (int key = 0; key < CAPACITY; ++key) {
+        plain.put(key, key);
+        filtered.put(key, key);
+    }
+
+    auto run = [&](CacheDemo::HashLRUCache<int, int>& cache) {
+        std::atomic<long> hits{0};
+        auto task = [&](int t) {
+            std::mt19937 gen(t);
+            std::uniform_int_distribution<> dist(0, 99);
+            std::uniform_int_distribution<> keyDist(0, CAPACITY - 1);
+            int value = 0;
+            long localHits = 0;
+            for (int op = 0; op < OPERATIONS / threadnum; ++op) {
+                int key = keyDist(gen);
+                // 不存在的 key 取自缓存范围之外
+                if (dist(gen) < MISS_PERCENT) key += CAPACITY;
+                if (cache.get(key, value)) ++localHits;
+            }
+            hits += localHits;
+        };
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadnum; ++t) {
+            threads.emplace_back(task, t);
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::chrono::duration<double, std::milli>(end - start).count() << " ms 命中率: "
+                  << 100.0 * hits / OPERATIONS << "%" << std::endl;
+    };
+
+    std::cout << "无过滤器 - 耗时: ";
+    run(plain);
+    std::cout << "有过滤器 - 耗时: ";
+    run(filtered);
+
+    // 淘汰、删除、清空之后过滤器不能漏报：缓存中的 key 全部能查到
+    CacheDemo::LRUCache<int, int> lru(CAPACITY / 4);
+    lru.enableMissFilter();
+    for (int key = 0; key < CAPACITY; ++key) {
+        lru.put(key, key);
+        if (key % 7 == 0) lru.deletenode(key);
+    }
+    bool ok = true;
+    int found = 0;
+    int value = 0;
+    for (int key = 0; key < CAPACITY; ++key) {
+        if (lru.get(key, value)) ++found;
+    }
+    ok = ok && found == static_cast<int>(lru.size());
+    lru.clear();
+    lru.put(1, 1);
+    ok = ok && !lru.get(2, value) && lru.get(1, value) && value == 1;
+    std::cout << "过滤器一致性检查: " << (ok ? "通过" : "失败") << std::endl;
+}
+
+// **LIRS 测试：略大于缓存的循环，未命中时回填；LRU 每次都在 key 被再次访问前把它淘汰**
+void testLIRS() {
+    std::cout << "\n=== 测试场景19：LIRS 循环抗性 ===" << std::endl;
+
+    const int CAPACITY = 400;
+    const int LOOP_SIZE = 500;
+    const int OPERATIONS = 200000;
+
+    CacheDemo::LRUCache<int, int> lru(CAPACITY);
+    // ArcCache 的 LRU、LFU 两部分各按 CAPACITY 计，实际最多能容纳约 2 倍条目
+    CacheDemo::ArcCache<int, int> arc(CAPACITY);
+    CacheDemo::S3FIFOCache<int, int> s3fifo(CAPACITY);
+    CacheDemo::LIRSCache<int, int> lirs(CAPACITY);
+    CacheDemo::LIRSCache<int, int> smallLirs(CAPACITY / 2);
+
+    std::array<CacheDemo::Cachepolicy<int, int>*, 5> caches = {&lru, &arc, &s3fifo, &lirs, &smallLirs};
+    const char* names[] = {"LRU", "ARC", "S3FIFO", "LIRS", "LIRS(半容量)"};
+    int value = 0;
+    for (int i = 0; i < caches.size(); ++i) {
+        std::mt19937 gen(i);
+        int hits = 0;
+        int current_pos = 0;
+        for (int op = 0; op < OPERATIONS; ++op) {
+            int key;
+            if (op % 100 < 80) {  // 80%顺序循环
+                key = current_pos;
+                current_pos = (current_pos + 1) % LOOP_SIZE;
+            } else {  // 20%随机访问循环内的 key
+                key = gen() % LOOP_SIZE;
+            }
+            if (caches[i]->get(key, value)) {
+                ++hits;
+            } else {
+                caches[i]->put(key, key);
+            }
+        }
+        std::cout << names[i] << " - 命中率: " << std::fixed << std::setprecision(2)
+                  << 100.0 * hits / OPERATIONS << "%" << std::endl;
+    }
+
+    // 容量为 1、清空后重新写入等边界情况
+    CacheDemo::LIRSCache<int, int> tiny(1);
+    tiny.put(1, 1);
+    tiny.put(2, 2);
+    bool ok = !tiny.get(1, value) && tiny.get(2) == 2 && tiny.size() == 1;
+    lirs.clear();
+    ok = ok && lirs.size() == 0 && !lirs.get(1, value);
+    for (int key = 0; key < CAPACITY * 3; ++key) {
+        lirs.put(key, key);
+    }
+    ok = ok && lirs.size() == CAPACITY && lirs.get(CAPACITY * 3 - 1) == CAPACITY * 3 - 1;
+    std::cout << "边界检查: " << (ok ? "通过" : "失败") << std::endl;
+}
+
+// **分段 LRU / 2Q 测试：热点访问与只出现一次的扫描 key 交错，比较热点 key 的命中率**
+void testScanResistance() {
+    std::cout << "\n=== 测试场景20：抗扫描（SLRU / 2Q） ===" << std::endl;
+
+    const int CAPACITY = 1000;
+    const int HOT_KEYS = 400;
+    const int OPERATIONS = 300000;
+    const int HOT_PERCENT = 30;  // 其余 70% 是一次性扫描
+
+    CacheDemo::LRUCache<int, int> lru(CAPACITY);
+    CacheDemo::SLRUCache<int, int> slru(CAPACITY);
+    CacheDemo::TwoQCache<int, int> twoq(CAPACITY);
+    CacheDemo::LIRSCache<int, int> lirs(CAPACITY);
+    CacheDemo::ShardedCache<int, int, CacheDemo::SLRUCache<int, int>> shardedSlru(CAPACITY, 4, 0.8);
+    CacheDemo::ShardedCache<int, int, CacheDemo::TwoQCache<int, int>> shardedTwoq(CAPACITY, 4);
+
+    std::array<CacheDemo::Cachepolicy<int, int>*, 6> caches = {&lru, &slru, &twoq, &lirs, &shardedSlru, &shardedTwoq};
+    const char* names[] = {"LRU", "SLRU", "2Q", "LIRS", "分片SLRU", "分片2Q"};
+    int value = 0;
+    for (int i = 0; i < caches.size(); ++i) {
+        std::mt19937 gen(i);
+        int hits = 0;
+        int gets = 0;
+        int scanKey = HOT_KEYS;
+        for (int op = 0; op < OPERATIONS; ++op) {
+            bool hot = gen() % 100 < HOT_PERCENT;
+            int key = hot ? gen() % HOT_KEYS : scanKey++;
+            if (hot) ++gets;
+            if (caches[i]->get(key, value)) {
+                if (hot) ++hits;
+            } else {
+                caches[i]->put(key, key);  // 未命中时回填
+            }
+        }
+        std::cout << names[i] << " - 热点命中率: " << std::fixed << std::setprecision(2)
+                  << 100.0 * hits / gets << "%" << std::endl;
+    }
+}
+
+// **采样淘汰测试：不同采样数/淘汰池下的命中率，以及每个条目的内存占用**
+void testSampledEviction() {
+    std::cout << "\n=== 测试场景21：采样淘汰 ===" << std::endl;
+
+    const int CAPACITY = 1000;
+    const int OPERATIONS = 500000;
+    const int HOT_KEYS = 800;
+    const int COLD_KEYS = 20000;
+
+    // 70% 访问热点，其余访问大范围冷数据，未命中时回填
+    auto run = [&](CacheDemo::Cachepolicy<int, int>& cache) {
+        std::mt19937 gen(42);
+        int hits = 0;
+        int value = 0;
+        for (int op = 0; op < OPERATIONS; ++op) {
+            int key = gen() % 100 < 70 ? gen() % HOT_KEYS : HOT_KEYS + gen() % COLD_KEYS;
+            if (cache.get(key, value)) {
+                ++hits;
+            } else {
+                cache.put(key, key);
+            }
+        }
+        return 100.0 * hits / OPERATIONS;
+    };
+
+    using CacheDemo::SampledPolicy;
+    CountingResource lruResource;
+    CacheDemo::LRUCache<int, int> lru(CAPACITY, &lruResource);
+    CacheDemo::LFUCache<int, int> lfu(CAPACITY);
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "LRU - 命中率: " << run(lru) << "%" << std::endl;
+    std::cout << "LFU - 命中率: " << run(lfu) << "%" << std::endl;
+
+    for (size_t samples : {1, 3, 5, 10}) {
+        CacheDemo::SampledCache<int, int> noPool(CAPACITY, SampledPolicy::LRU, samples, 0);
+        CacheDemo::SampledCache<int, int> pooled(CAPACITY, SampledPolicy::LRU, samples, 16);
+        double noPoolRate = run(noPool);
+        std::cout << "采样LRU(" << samples << ") - 命中率: " << noPoolRate
+                  << "% 淘汰池: " << run(pooled) << "%" << std::endl;
+    }
+    CacheDemo::SampledCache<int, int> sampledLfu(CAPACITY, SampledPolicy::LFU, 5, 16);
+    std::cout << "采样LFU(5) - 命中率: " << run(sampledLfu) << "%" << std::endl;
+
+    // 每个条目的元数据开销：LRU 为链表节点 + 哈希节点 + 桶，采样缓存为数组槽位（含空槽）
+    CacheDemo::SampledCache<int, int> sampled(CAPACITY);
+    run(sampled);
+    std::cout << "LRU - 每条目字节数: " << lruResource.outstanding / lru.size() << std::endl;
+    std::cout << "采样缓存 - 每条目字节数: " << sampled.tableBytes() / sampled.size() << std::endl;
+}
+
+// **组相联缓存测试：整数 key 的吞吐与命中率，以及并发写入下乐观读不会读到撕裂的值**
+void testSetAssociative() {
+    std::cout << "\n=== 测试场景22：组相联缓存 ===" << std::endl;
+
+    const int CAPACITY = 1 << 16;
+    const int OPERATIONS = 4000000;
+    const int threadnum = 4;
+    const int KEY_RANGE = CAPACITY * 2;
+
+    auto run = [&](auto& cache, int threads) {
+        std::atomic<long> hits{0};
+        auto task = [&](int t) {
+            std::mt19937 gen(t);
+            long localHits = 0;
+            int value = 0;
+            for (int op = 0; op < OPERATIONS / threads; ++op) {
+                // 约一半访问集中在 1/8 的热点 key 上
+                int key = gen() % 2 ? gen() % (KEY_RANGE / 8) : gen() % KEY_RANGE;
+                if (cache.get(key, value)) {
+                    ++localHits;
+                } else {
+                    cache.put(key, key);
+                }
+            }
+            hits += localHits;
+        };
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back(task, t);
+        }
+        for (auto& t : workers) {
+            t.join();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        std::cout << std::fixed << std::setprecision(2) << "命中率: " << 100.0 * hits / OPERATIONS
+                  << "% 吞吐: " << OPERATIONS / ms << " ops/ms" << std::endl;
+    };
+
+    // 组相联缓存的桶数取 2 的幂，实际容量可能大于 CAPACITY，对照组使用相同的实际容量
+    CacheDemo::SetAssociativeCache<int, int> setAssoc(CAPACITY);
+    CacheDemo::LRUCache<int, int> lru(setAssoc.capacity());
+    CacheDemo::HashLRUCache<int, int> hashLru(setAssoc.capacity(), threadnum);
+    std::cout << "桶大小: " << setAssoc.bucketBytes() << " 字节, 每桶 " << setAssoc.ways()
+              << " 路, 容量: " << setAssoc.capacity() << std::endl;
+    std::cout << "LRU 单线程 - ";
+    run(lru, 1);
+    std::cout << "组相联 单线程 - ";
+    run(setAssoc, 1);
+    setAssoc.clear();
+    std::cout << "HASHLRU " << threadnum << "线程 - ";
+    run(hashLru, threadnum);
+    std::cout << "组相联 " << threadnum << "线程 - ";
+    run(setAssoc, threadnum);
+
+    // 值由两个互补的字组成，读到撕裂的值说明序列锁失效
+    struct Pair {
+        uint64_t a;
+        uint64_t b;
+        bool operator==(const Pair& other) const { return a == other.a && b == other.b; }
+    };
+    CacheDemo::SetAssociativeCache<int, Pair> pairs(64);
+    std::atomic<bool> stop{false};
+    std::atomic<long> torn{0};
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 2; ++t) {
+        writers.emplace_back([&, t]() {
+            std::mt19937_64 gen(t);
+            while (!stop) {
+                uint64_t a = gen();
+                pairs.put(gen() % 128, Pair{a, ~a});
+            }
+        });
+    }
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 2; ++t) {
+        readers.emplace_back([&, t]() {
+            std::mt19937 gen(t);
+            Pair pair{};
+            for (int op = 0; op < 500000; ++op) {
+                if (pairs.get(gen() % 128, pair) && pair.b != ~pair.a) ++torn;
+            }
+        });
+    }
+    for (auto& t : readers) {
+        t.join();
+    }
+    stop = true;
+    for (auto& t : writers) {
+        t.join();
+    }
+    std::cout << "并发读写 - 撕裂读取: " << torn << (torn == 0 ? " 通过" : " 失败") << std::endl;
+}
+
+void testDenseKeys() {
+    std::cout << "\n=== 测试场景23：稠密整数key ===" << std::endl;
+
+    const int CAPACITY = 1 << 14;
+    const int OPERATIONS = 4000000;
+    constexpr size_t KEY_SPACE = 1 << 17;
+
+    // 通过 Cachepolicy 接口访问，稠密实现可直接替换原有策略
+    auto run = [&](CacheDemo::Cachepolicy<int, int>& cache) {
+        std::mt19937 gen(42);
+        long hits = 0;
+        int value = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int op = 0; op < OPERATIONS; ++op) {
+            // 约 70% 访问集中在 1/16 的热点 key 上
+            int key = gen() % 10 < 7 ? gen() % (KEY_SPACE / 16) : gen() % KEY_SPACE;
+            if (cache.get(key, value)) {
+                ++hits;
+            } else {
+                cache.put(key, key);
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        std::cout << std::fixed << std::setprecision(2) << "命中率: " << 100.0 * hits / OPERATIONS
+                  << "% 吞吐: " << OPERATIONS / ms << " ops/ms" << std::endl;
+    };
+
+    CacheDemo::LRUCache<int, int> lru(CAPACITY);
+    CacheDemo::DenseLRUCache<int, int, KEY_SPACE> denseLru(CAPACITY);
+    CacheDemo::LFUCache<int, int> lfu(CAPACITY);
+    CacheDemo::DenseLFUCache<int, int, KEY_SPACE> denseLfu(CAPACITY);
+    std::cout << "LRU - ";
+    run(lru);
+    std::cout << "稠密LRU - ";
+    run(denseLru);
+    std::cout << "LFU - ";
+    run(lfu);
+    std::cout << "稠密LFU - ";
+    run(denseLfu);
+
+    // 范围外的 key 不会被缓存
+    int value = 0;
+    denseLru.put(-1, 1);
+    denseLru.put(static_cast<int>(KEY_SPACE), 1);
+    bool ignored = !denseLru.get(-1, value) && !denseLru.get(static_cast<int>(KEY_SPACE), value);
+    std::cout << "范围外key - " << (ignored ? "通过" : "失败") << std::endl;
+}
+
+// 用 perf_event_open 统计本线程用户态的 dTLB 读未命中，内核或虚拟机不支持时 available() 为 false
+class DtlbMissCounter {
+public:
+    DtlbMissCounter() {
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+    ~DtlbMissCounter() {
+        if (fd_ >= 0) close(fd_);
+    }
+
+    bool available() const { return fd_ >= 0; }
+
+    void start() {
+        if (fd_ < 0) return;
+        ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+    }
+
+    long stop() {
+        if (fd_ < 0) return 0;
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        long long count = 0;
+        if (read(fd_, &count, sizeof(count)) != sizeof(count)) return 0;
+        return static_cast<long>(count);
+    }
+
+private:
+    int fd_;
+};
+
+// 进程当前使用的透明大页，单位 kB
+long anonHugePagesKb() {
+    std::ifstream smaps("/proc/self/smaps_rollup");
+    std::string name;
+    long kb = 0;
+    while (smaps >> name) {
+        if (name == "AnonHugePages:") {
+            smaps >> kb;
+            break;
+        }
+    }
+    return kb;
+}
+
+// **大页测试：百万级条目的随机查找，链表节点和哈希桶放在大页上以减少 TLB 未命中**
+void testHugePageArena() {
+    std::cout << "\n=== 测试场景24：大页内存 ===" << std::endl;
+
+    const int CAPACITY = 1 << 21;
+    const int OPERATIONS = 4000000;
+
+    std::vector<int> keys(CAPACITY);
+    for (int i = 0; i < CAPACITY; ++i) {
+        keys[i] = i;
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+
+    DtlbMissCounter counter;
+    auto run = [&](std::pmr::memory_resource* resource) {
+        CacheDemo::LRUCache<int, int> cache(CAPACITY, resource);
+        for (int key : keys) {
+            cache.put(key, key);
+        }
+        std::mt19937 gen(42);
+        long hits = 0;
+        int value = 0;
+        counter.start();
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int op = 0; op < OPERATIONS; ++op) {
+            if (cache.get(gen() % CAPACITY, value)) ++hits;
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        long misses = counter.stop();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        std::cout << std::fixed << std::setprecision(2) << "命中率: " << 100.0 * hits / OPERATIONS
+                  << "% 查找延迟: " << ms * 1e6 / OPERATIONS << " ns";
+        if (counter.available()) {
+            std::cout << " dTLB未命中/次: " << static_cast<double>(misses) / OPERATIONS;
+        }
+        std::cout << " 透明大页: " << anonHugePagesKb() / 1024 << " MB" << std::endl;
+    };
+
+    if (!counter.available()) {
+        std::cout << "perf 计数器不可用，只比较延迟" << std::endl;
+    }
+    std::cout << "默认分配器 - ";
+    run(std::pmr::get_default_resource());
+    {
+        // 同样经过内存池，只有上游不同，区分池化本身和大页的作用
+        std::pmr::unsynchronized_pool_resource pool;
+        std::cout << "内存池 - ";
+        run(&pool);
+    }
+    {
+        CacheDemo::HugePageArena arena;
+        std::pmr::unsynchronized_pool_resource pool(&arena);
+        std::cout << "大页内存池 - ";
+        run(&pool);
+        std::cout << "映射: " << arena.mappedBytes() / (1024 * 1024) << " MB, 其中 hugetlbfs: "
+                  << arena.hugetlbBytes() / (1024 * 1024) << " MB" << std::endl;
+    }
+}
+
+// **批量查找测试：缓存远大于末级缓存时，逐个 get 与分组查找的 getMany 对比**
+void testGetMany() {
+    std::cout << "\n=== 测试场景25：批量查找 ===" << std::endl;
+
+    const int CAPACITY = 1 << 21;
+    const int OPERATIONS = 4000000;
+    const int BATCH = 64;
+    const int threadnum = 4;
+
+    CacheDemo::HashLRUCache<int, int> cache(CAPACITY, threadnum);
+    for (int key = 0; key < CAPACITY; ++key) {
+        cache.put(key, key);
+    }
+    // 约 90% 的 key 命中
+    std::mt19937 gen(42);
+    std::vector<int> keys(OPERATIONS);
+    for (int& key : keys) {
+        key = gen() % (CAPACITY + CAPACITY / 9);
+    }
+
+    auto report = [&](const char* name, long hits, std::chrono::high_resolution_clock::time_point start) {
+        auto end = std::chrono::high_resolution_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        std::cout << std::fixed << std::setprecision(2) << name << " - 命中率: " << 100.0 * hits / OPERATIONS
+                  << "% 平均延迟: " << ms * 1e6 / OPERATIONS << " ns" << std::endl;
+    };
+
+    std::vector<int> values(BATCH);
+    std::unique_ptr<bool[]> found(new bool[BATCH]);
+    long hits = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int op = 0; op < OPERATIONS; ++op) {
+        if (cache.get(keys[op], values[0])) ++hits;
+    }
+    report("逐个get", hits, start);
+
+    hits = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (int op = 0; op < OPERATIONS; op += BATCH) {
+        hits += cache.getMany(&keys[op], std::min(BATCH, OPERATIONS - op), values.data(), found.get());
+    }
+    report("getMany", hits, start);
+}
+
+// **自适应策略测试：频率友好与近期性友好的阶段交替出现，自适应缓存随阶段切换淘汰方式**
+void testAdaptivePolicy() {
+    std::cout << "\n=== 测试场景26：自适应策略 ===" << std::endl;
+
+    const int CAPACITY = 8000;
+    const int PHASE_LENGTH = 400000;
+    const int PHASES = 4;
+
+    CacheDemo::LRUCache<int, int> lru(CAPACITY);
+    CacheDemo::LFUCache<int, int> lfu(CAPACITY);
+    // ARC 两部分各自最多容纳 capacity 个 key，减半后总容量相当
+    CacheDemo::ArcCache<int, int> arc(CAPACITY / 2);
+    CacheDemo::AdaptiveCache<int, int> adaptive(CAPACITY);
+    std::array<CacheDemo::Cachepolicy<int, int>*, 4> caches = {&lru, &lfu, &arc, &adaptive};
+    const char* names[] = {"LRU", "LFU", "ARC", "自适应"};
+    const char* leaders[] = {"LRU", "LFU", "ARC", "FIFO"};
+
+    for (int i = 0; i < caches.size(); ++i) {
+        std::mt19937 gen(1);
+        std::vector<long> hits(PHASES, 0);
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int phase = 0; phase < PHASES; ++phase) {
+            for (int op = 0; op < PHASE_LENGTH; ++op) {
+                int key;
+                if (phase % 2 == 0) {
+                    // 稳定的偏斜热点混入大量一次性扫描，频率更有用
+                    if (gen() % 100 < 60) {
+                        double u = (gen() % 100000 + 1) / 100000.0;
+                        key = static_cast<int>(u * u * u * CAPACITY * 3);
+                    } else {
+                        key = 10000000 + gen() % 10000000;
+                    }
+                } else {
+                    // 缓慢移动的工作集，旧热点不再访问，近期性更有用
+                    key = 1000000 + op / 25 + gen() % (CAPACITY * 4 / 5);
+                }
+                int value = 0;
+                if (caches[i]->get(key, value)) {
+                    ++hits[phase];
+                } else {
+                    caches[i]->put(key, key);
+                }
+            }
+            if (caches[i] == &adaptive) {
+                std::cout << "阶段" << phase + 1 << "结束 - 领先影子: "
+                          << leaders[static_cast<int>(adaptive.leader())]
+                          << " LFU权重: " << std::setprecision(2) << adaptive.lfuWeight() << std::endl;
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        long total = 0;
+        std::cout << names[i] << " - 各阶段命中率:";
+        for (int phase = 0; phase < PHASES; ++phase) {
+            std::cout << " " << std::fixed << std::setprecision(2) << 100.0 * hits[phase] / PHASE_LENGTH << "%";
+            total += hits[phase];
+        }
+        std::cout << " 总命中率: " << 100.0 * total / (PHASE_LENGTH * PHASES) << "% 耗时: " << ms << " ms"
+                  << std::endl;
+    }
+}
+
+// **值压缩测试：相同字节预算下，冷数据压缩后能容纳更多条目**
+void testCompressedValues() {
+    std::cout << "\n=== 测试场景27：值压缩 ===" << std::endl;
+
+    const int KEYS = 20000;
+    const int OPERATIONS = 200000;
+    const size_t BUDGET = 8 << 20;
+    const int threadnum = 4;
+
+    // JSON 风格的值，字段名和取值重复较多
+    auto makeValue = [](int key) {
+        std::string value = "[";
+        for (int i = 0; i < 12; ++i) {
+            value += "{\"id\":" + std::to_string(key * 12 + i) + ",\"user\":\"user_" + std::to_string((key + i) % 97) +
+                     "\",\"status\":\"" + (i % 3 ? "active" : "inactive") + "\",\"score\":" +
+                     std::to_string((key * 31 + i * 7) % 1000) + ",\"tags\":[\"cache\",\"demo\"]},";
+        }
+        value.back() = ']';
+        return value;
+    };
+    std::vector<std::string> values(KEYS);
+    for (int key = 0; key < KEYS; ++key) {
+        values[key] = makeValue(key);
+    }
+
+    auto run = [&](const char* name, CacheDemo::Cachepolicy<int, std::string>& cache) {
+        std::mt19937 gen(42);
+        long hits = 0;
+        long wrong = 0;
+        std::string value;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int op = 0; op < OPERATIONS; ++op) {
+            // 偏斜访问，热点集中在前部的 key
+            double u = (gen() % 100000) / 100000.0;
+            int key = static_cast<int>(u * u * KEYS);
+            if (cache.get(key, value)) {
+                ++hits;
+                if (value != values[key]) ++wrong;
+            } else {
+                cache.put(key, values[key]);
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        std::cout << std::fixed << std::setprecision(2) << name << " - 命中率: " << 100.0 * hits / OPERATIONS
+                  << "% 吞吐: " << OPERATIONS / ms << " ops/ms" << (wrong == 0 ? "" : " 读到错误数据") << std::endl;
+    };
+
+    std::cout << "值大小约 " << values[0].size() << " 字节, 字节预算: " << (BUDGET >> 20) << " MB" << std::endl;
+    CacheDemo::CompressedLRUCache<int> plain(BUDGET, 0.25, SIZE_MAX);
+    run("不压缩", plain);
+    std::cout << "条目数: " << plain.size() << std::endl;
+
+    CacheDemo::CompressedLRUCache<int> compressed(BUDGET);
+    run("压缩冷数据", compressed);
+    std::cout << "条目数: " << compressed.size() << " 其中压缩: " << compressed.compressedCount() << std::endl;
+
+    CacheDemo::ShardedCache<int, std::string, CacheDemo::CompressedLRUCache<int>> sharded(BUDGET, threadnum);
+    run("分片压缩", sharded);
+    std::cout << "条目数: " << sharded.size() << std::endl;
+
+    // 压缩后仍超出预算的值被拒绝，不能把已有条目全部挤掉
+    CacheDemo::CompressedLRUCache<int> small(100 << 10);
+    for (int key = 0; key < 50; ++key) {
+        small.put(key, values[key]);
+    }
+    size_t before = small.size();
+    std::mt19937 gen(7);
+    std::string noise(200 << 10, '\0');
+    for (auto& c : noise) c = static_cast<char>(gen());
+    small.put(KEYS, noise);
+    std::string out;
+    std::cout << "超大值写入后条目数: " << small.size() << "/" << before
+              << (small.size() == before && !small.get(KEYS, out) ? " 通过" : " 失败") << std::endl;
+}
+
 // **主函数**
 int main()
 {
@@ -495,5 +2020,29 @@ int main()
     benchmark("多线程分片LRU测试开始：", test_hashmulti_performance);
     benchmark("循环扫描测试开始：", testLoopPattern);
     benchmark("剧烈变动工作环境开始：", testWorkloadShift);
+    benchmark("分层缓存测试开始：", testTieredCache);
+    benchmark("后台淘汰测试开始：", testAsyncEviction);
+    benchmark("移除监听测试开始：", testRemovalListener);
+    benchmark("写回缓存测试开始：", testWriteBehind);
+    benchmark("在线扩缩容测试开始：", testOnlineResize);
+    benchmark("热点复制测试开始：", testHotKeyReplication);
+    benchmark("纪元回收测试开始：", testEpochReclaim);
+    benchmark("S3-FIFO测试开始：", testS3FIFO);
+    benchmark("NUMA分片测试开始：", testNumaSharding);
+    benchmark("两级缓存测试开始：", testTwoLevelCache);
+    benchmark("策略组合测试开始：", testPolicyComposition);
+    benchmark("批量清空测试开始：", testClear);
+    benchmark("原子读改写测试开始：", testAtomicOps);
+    benchmark("内存资源测试开始：", testPmrAllocation);
+    benchmark("未命中过滤测试开始：", testMissFilter);
+    benchmark("LIRS测试开始：", testLIRS);
+    benchmark("抗扫描测试开始：", testScanResistance);
+    benchmark("采样淘汰测试开始：", testSampledEviction);
+    benchmark("组相联缓存测试开始：", testSetAssociative);
+    benchmark("稠密整数key测试开始：", testDenseKeys);
+    benchmark("大页内存测试开始：", testHugePageArena);
+    benchmark("批量查找测试开始：", testGetMany);
+    benchmark("自适应策略测试开始：", testAdaptivePolicy);
+    benchmark("值压缩测试开始：", testCompressedValues);
     return 0;
 }